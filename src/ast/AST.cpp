@@ -0,0 +1,28 @@
+#include "AST.h"
+
+const char *getOpText(Unary::Op op) {
+    switch (op) {
+    case Unary::NEG: return "-";
+    case Unary::NOT: return "!";
+    }
+    return "";
+}
+
+const char *getOpText(Binary::Op op) {
+    switch (op) {
+    case Binary::MUL: return "*";
+    case Binary::DIV: return "/";
+    case Binary::MOD: return "%";
+    case Binary::ADD: return "+";
+    case Binary::SUB: return "-";
+    case Binary::LE: return "<=";
+    case Binary::LT: return "<";
+    case Binary::GE: return ">=";
+    case Binary::GT: return ">";
+    case Binary::EQ: return "==";
+    case Binary::NE: return "!=";
+    case Binary::AND: return "&&";
+    case Binary::OR: return "||";
+    }
+    return "";
+}
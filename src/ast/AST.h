@@ -0,0 +1,413 @@
+#ifndef _AST_H_
+#define _AST_H_
+
+#include "Name.h"
+#include "utils/Pos.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Allocator.h"
+#include "llvm/Support/StringSaver.h"
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+// Decaf syntax tree, lowered once from the ANTLR parse tree so that the
+// later phases don't depend on it. Nodes are plain data allocated in the
+// arena of an ASTContext and are all released together with it; they never
+// own anything that needs a destructor. Names are interned in the context's
+// string pool, where equal names share storage.
+
+struct ASTNode {
+    enum Kind {
+        // declarations
+        TOP_LEVEL,
+        CLASS_DEF,
+        METHOD_DEF,
+        VAR_DEF,
+        TYPE_LIT,
+
+        // statements
+        BLOCK,
+        LOCAL_VAR_DEF,
+        ASSIGN,
+        EXPR_STMT,
+        IF_STMT,
+        WHILE_STMT,
+        FOR_STMT,
+        BREAK_STMT,
+        RETURN_STMT,
+        PRINT_STMT,
+        EMPTY_STMT,
+
+        // expressions
+        INT_LIT,
+        BOOL_LIT,
+        NULL_LIT,
+        STRING_LIT,
+        THIS_EXPR,
+        VAR_SEL,
+        INDEX_SEL,
+        CALL,
+        PAREN,
+        UNARY,
+        BINARY,
+        CAST,
+        READ_INT,
+        READ_LINE,
+        CLASS_NEW,
+        ARRAY_NEW,
+        INSTANCEOF,
+    };
+
+    const Kind kind;
+    // position of the token the node is reported at
+    Pos pos;
+    // numbered in creation order by the ASTContext, indexes side tables
+    unsigned id = 0;
+
+    ASTNode(Kind kind, const Pos &pos) : kind(kind), pos(pos) {}
+};
+
+struct Stmt : ASTNode {
+    using ASTNode::ASTNode;
+};
+
+// pos is where the expression starts
+struct Expr : ASTNode {
+    using ASTNode::ASTNode;
+};
+
+// Declarations
+
+// int, bool, string, void, class <name> or <type>[]
+struct TypeLit : ASTNode {
+    enum Base { INT, BOOL, STRING, VOID, CLASS, ARRAY };
+
+    Base base;
+    Name className;
+    TypeLit *elem = nullptr;
+
+    TypeLit(const Pos &pos, Base base) : ASTNode(TYPE_LIT, pos), base(base) {}
+};
+
+// Field, parameter or local variable, pos is its name
+struct VarDef : ASTNode {
+    TypeLit *type;
+    Name name;
+
+    VarDef(const Pos &pos, TypeLit *type, Name name)
+        : ASTNode(VAR_DEF, pos), type(type), name(name) {}
+};
+
+struct Block;
+
+// pos is the method's name
+struct MethodDef : ASTNode {
+    bool isStatic;
+    TypeLit *retType;
+    Name name;
+    llvm::ArrayRef<VarDef *> params;
+    Block *body;
+
+    MethodDef(const Pos &pos, bool isStatic, TypeLit *retType, Name name,
+              llvm::ArrayRef<VarDef *> params, Block *body)
+        : ASTNode(METHOD_DEF, pos), isStatic(isStatic), retType(retType),
+          name(name), params(params), body(body) {}
+};
+
+// pos is the 'class' keyword. Fields are VarDefs and MethodDefs in source
+// order, baseName is empty without an extends clause
+struct ClassDef : ASTNode {
+    Name name;
+    Name baseName;
+    llvm::ArrayRef<ASTNode *> fields;
+
+    ClassDef(const Pos &pos, Name name, Name baseName,
+             llvm::ArrayRef<ASTNode *> fields)
+        : ASTNode(CLASS_DEF, pos), name(name), baseName(baseName),
+          fields(fields) {}
+};
+
+struct TopLevel : ASTNode {
+    llvm::ArrayRef<ClassDef *> classes;
+
+    TopLevel(const Pos &pos, llvm::ArrayRef<ClassDef *> classes)
+        : ASTNode(TOP_LEVEL, pos), classes(classes) {}
+};
+
+// Statements
+
+// pos is the left brace
+struct Block : Stmt {
+    llvm::ArrayRef<Stmt *> stmts;
+
+    Block(const Pos &pos, llvm::ArrayRef<Stmt *> stmts)
+        : Stmt(BLOCK, pos), stmts(stmts) {}
+};
+
+// init is null without an initializer, opPos is its '='
+struct LocalVarDef : Stmt {
+    VarDef *var;
+    Expr *init;
+    Pos opPos;
+
+    LocalVarDef(VarDef *var, Expr *init, const Pos &opPos)
+        : Stmt(LOCAL_VAR_DEF, var->type->pos), var(var), init(init),
+          opPos(opPos) {}
+};
+
+// lValue is a VarSel or an IndexSel, opPos is the '='
+struct Assign : Stmt {
+    Expr *lValue;
+    Expr *expr;
+    Pos opPos;
+
+    Assign(Expr *lValue, Expr *expr, const Pos &opPos)
+        : Stmt(ASSIGN, lValue->pos), lValue(lValue), expr(expr),
+          opPos(opPos) {}
+};
+
+struct ExprStmt : Stmt {
+    Expr *expr;
+
+    ExprStmt(Expr *expr) : Stmt(EXPR_STMT, expr->pos), expr(expr) {}
+};
+
+// elseStmt is null without an else branch
+struct IfStmt : Stmt {
+    Expr *cond;
+    Stmt *thenStmt;
+    Stmt *elseStmt;
+
+    IfStmt(const Pos &pos, Expr *cond, Stmt *thenStmt, Stmt *elseStmt)
+        : Stmt(IF_STMT, pos), cond(cond), thenStmt(thenStmt),
+          elseStmt(elseStmt) {}
+};
+
+struct WhileStmt : Stmt {
+    Expr *cond;
+    Stmt *body;
+
+    WhileStmt(const Pos &pos, Expr *cond, Stmt *body)
+        : Stmt(WHILE_STMT, pos), cond(cond), body(body) {}
+};
+
+// init is a LocalVarDef or an Assign, update an Assign or an ExprStmt. Both
+// may be null
+struct ForStmt : Stmt {
+    Stmt *init;
+    Expr *cond;
+    Stmt *update;
+    Stmt *body;
+
+    ForStmt(const Pos &pos, Stmt *init, Expr *cond, Stmt *update, Stmt *body)
+        : Stmt(FOR_STMT, pos), init(init), cond(cond), update(update),
+          body(body) {}
+};
+
+struct BreakStmt : Stmt {
+    BreakStmt(const Pos &pos) : Stmt(BREAK_STMT, pos) {}
+};
+
+// expr is null in 'return;'
+struct ReturnStmt : Stmt {
+    Expr *expr;
+
+    ReturnStmt(const Pos &pos, Expr *expr)
+        : Stmt(RETURN_STMT, pos), expr(expr) {}
+};
+
+struct PrintStmt : Stmt {
+    llvm::ArrayRef<Expr *> args;
+
+    PrintStmt(const Pos &pos, llvm::ArrayRef<Expr *> args)
+        : Stmt(PRINT_STMT, pos), args(args) {}
+};
+
+struct EmptyStmt : Stmt {
+    EmptyStmt(const Pos &pos) : Stmt(EMPTY_STMT, pos) {}
+};
+
+// Expressions
+
+struct IntLit : Expr {
+    int value;
+
+    IntLit(const Pos &pos, int value) : Expr(INT_LIT, pos), value(value) {}
+};
+
+struct BoolLit : Expr {
+    bool value;
+
+    BoolLit(const Pos &pos, bool value) : Expr(BOOL_LIT, pos), value(value) {}
+};
+
+struct NullLit : Expr {
+    NullLit(const Pos &pos) : Expr(NULL_LIT, pos) {}
+};
+
+// value has the escapes resolved
+struct StringLit : Expr {
+    llvm::StringRef value;
+
+    StringLit(const Pos &pos, llvm::StringRef value)
+        : Expr(STRING_LIT, pos), value(value) {}
+};
+
+struct ThisExpr : Expr {
+    ThisExpr(const Pos &pos) : Expr(THIS_EXPR, pos) {}
+};
+
+// <name> or <receiver>.<name>
+struct VarSel : Expr {
+    Expr *receiver;
+    Name name;
+    Pos namePos;
+
+    VarSel(const Pos &pos, Expr *receiver, Name name, const Pos &namePos)
+        : Expr(VAR_SEL, pos), receiver(receiver), name(name),
+          namePos(namePos) {}
+};
+
+// opPos is the '['
+struct IndexSel : Expr {
+    Expr *array;
+    Expr *index;
+    Pos opPos;
+
+    IndexSel(Expr *array, Expr *index, const Pos &opPos)
+        : Expr(INDEX_SEL, array->pos), array(array), index(index),
+          opPos(opPos) {}
+};
+
+// <name>(...) or <receiver>.<name>(...), lparenPos is the '('
+struct Call : Expr {
+    Expr *receiver;
+    Name name;
+    Pos namePos;
+    Pos lparenPos;
+    llvm::ArrayRef<Expr *> args;
+
+    Call(const Pos &pos, Expr *receiver, Name name, const Pos &namePos,
+         const Pos &lparenPos, llvm::ArrayRef<Expr *> args)
+        : Expr(CALL, pos), receiver(receiver), name(name), namePos(namePos),
+          lparenPos(lparenPos), args(args) {}
+};
+
+struct Paren : Expr {
+    Expr *expr;
+
+    Paren(const Pos &pos, Expr *expr) : Expr(PAREN, pos), expr(expr) {}
+};
+
+struct Unary : Expr {
+    enum Op { NEG, NOT };
+
+    Op op;
+    Expr *operand;
+
+    Unary(const Pos &pos, Op op, Expr *operand)
+        : Expr(UNARY, pos), op(op), operand(operand) {}
+};
+
+struct Binary : Expr {
+    enum Op { MUL, DIV, MOD, ADD, SUB, LE, LT, GE, GT, EQ, NE, AND, OR };
+
+    Op op;
+    Expr *lhs;
+    Expr *rhs;
+    Pos opPos;
+
+    Binary(Op op, Expr *lhs, Expr *rhs, const Pos &opPos)
+        : Expr(BINARY, lhs->pos), op(op), lhs(lhs), rhs(rhs), opPos(opPos) {}
+};
+
+// (class <className>) <expr>
+struct Cast : Expr {
+    Name className;
+    Pos classPos;
+    Expr *expr;
+
+    Cast(const Pos &pos, Name className, const Pos &classPos, Expr *expr)
+        : Expr(CAST, pos), className(className), classPos(classPos),
+          expr(expr) {}
+};
+
+struct ReadInt : Expr {
+    ReadInt(const Pos &pos) : Expr(READ_INT, pos) {}
+};
+
+struct ReadLine : Expr {
+    ReadLine(const Pos &pos) : Expr(READ_LINE, pos) {}
+};
+
+struct ClassNew : Expr {
+    Name className;
+
+    ClassNew(const Pos &pos, Name className)
+        : Expr(CLASS_NEW, pos), className(className) {}
+};
+
+// new <elemType>[<length>]
+struct ArrayNew : Expr {
+    TypeLit *elemType;
+    Expr *length;
+
+    ArrayNew(const Pos &pos, TypeLit *elemType, Expr *length)
+        : Expr(ARRAY_NEW, pos), elemType(elemType), length(length) {}
+};
+
+struct Instanceof : Expr {
+    Expr *expr;
+    Name className;
+    Pos classPos;
+
+    Instanceof(const Pos &pos, Expr *expr, Name className, const Pos &classPos)
+        : Expr(INSTANCEOF, pos), expr(expr), className(className),
+          classPos(classPos) {}
+};
+
+// Source text of an operator, as used in error messages
+const char *getOpText(Unary::Op op);
+const char *getOpText(Binary::Op op);
+
+// Owns the nodes and names of one program's tree
+class ASTContext {
+public:
+    ASTContext() : names(allocator), strings(allocator) {}
+    ASTContext(const ASTContext &) = delete;
+    ASTContext &operator=(const ASTContext &) = delete;
+
+    template <typename T, typename... Args> T *create(Args &&...args) {
+        T *node = new (allocator.Allocate<T>()) T(std::forward<Args>(args)...);
+        node->id = numNodes++;
+        return node;
+    }
+
+    // Node ids are below this
+    unsigned getNumNodes() const { return numNodes; }
+
+    template <typename T> llvm::ArrayRef<T> copyArray(const std::vector<T> &v) {
+        if (v.empty()) {
+            return llvm::None;
+        }
+        T *data = allocator.Allocate<T>(v.size());
+        std::copy(v.begin(), v.end(), data);
+        return llvm::ArrayRef<T>(data, v.size());
+    }
+
+    // Identifiers, the same text always gives the same Name
+    Name intern(llvm::StringRef name) { return Name(names.save(name)); }
+    // Literal contents, not deduplicated
+    llvm::StringRef save(llvm::StringRef text) { return strings.save(text); }
+
+    TopLevel *root = nullptr;
+
+private:
+    llvm::BumpPtrAllocator allocator;
+    llvm::UniqueStringSaver names;
+    llvm::StringSaver strings;
+    unsigned numNodes = 0;
+};
+
+#endif
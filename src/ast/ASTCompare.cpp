@@ -0,0 +1,217 @@
+#include "ASTCompare.h"
+
+// Children in a fixed order, absent ones as null
+static void getChildren(const ASTNode *node,
+                        std::vector<const ASTNode *> &children) {
+    auto add = [&](llvm::ArrayRef<const ASTNode *> nodes) {
+        children.insert(children.end(), nodes.begin(), nodes.end());
+    };
+
+    switch (node->kind) {
+    case ASTNode::TOP_LEVEL: {
+        auto *n = static_cast<const TopLevel *>(node);
+        children.assign(n->classes.begin(), n->classes.end());
+        break;
+    }
+    case ASTNode::CLASS_DEF: {
+        auto *n = static_cast<const ClassDef *>(node);
+        children.assign(n->fields.begin(), n->fields.end());
+        break;
+    }
+    case ASTNode::METHOD_DEF: {
+        auto *n = static_cast<const MethodDef *>(node);
+        add({n->retType, n->body});
+        children.insert(children.end(), n->params.begin(), n->params.end());
+        break;
+    }
+    case ASTNode::VAR_DEF:
+        add({static_cast<const VarDef *>(node)->type});
+        break;
+    case ASTNode::TYPE_LIT:
+        add({static_cast<const TypeLit *>(node)->elem});
+        break;
+    case ASTNode::BLOCK: {
+        auto *n = static_cast<const Block *>(node);
+        children.assign(n->stmts.begin(), n->stmts.end());
+        break;
+    }
+    case ASTNode::LOCAL_VAR_DEF: {
+        auto *n = static_cast<const LocalVarDef *>(node);
+        add({n->var, n->init});
+        break;
+    }
+    case ASTNode::ASSIGN: {
+        auto *n = static_cast<const Assign *>(node);
+        add({n->lValue, n->expr});
+        break;
+    }
+    case ASTNode::EXPR_STMT:
+        add({static_cast<const ExprStmt *>(node)->expr});
+        break;
+    case ASTNode::IF_STMT: {
+        auto *n = static_cast<const IfStmt *>(node);
+        add({n->cond, n->thenStmt, n->elseStmt});
+        break;
+    }
+    case ASTNode::WHILE_STMT: {
+        auto *n = static_cast<const WhileStmt *>(node);
+        add({n->cond, n->body});
+        break;
+    }
+    case ASTNode::FOR_STMT: {
+        auto *n = static_cast<const ForStmt *>(node);
+        add({n->init, n->cond, n->update, n->body});
+        break;
+    }
+    case ASTNode::RETURN_STMT:
+        add({static_cast<const ReturnStmt *>(node)->expr});
+        break;
+    case ASTNode::PRINT_STMT: {
+        auto *n = static_cast<const PrintStmt *>(node);
+        children.assign(n->args.begin(), n->args.end());
+        break;
+    }
+    case ASTNode::VAR_SEL:
+        add({static_cast<const VarSel *>(node)->receiver});
+        break;
+    case ASTNode::INDEX_SEL: {
+        auto *n = static_cast<const IndexSel *>(node);
+        add({n->array, n->index});
+        break;
+    }
+    case ASTNode::CALL: {
+        auto *n = static_cast<const Call *>(node);
+        add({n->receiver});
+        children.insert(children.end(), n->args.begin(), n->args.end());
+        break;
+    }
+    case ASTNode::PAREN:
+        add({static_cast<const Paren *>(node)->expr});
+        break;
+    case ASTNode::UNARY:
+        add({static_cast<const Unary *>(node)->operand});
+        break;
+    case ASTNode::BINARY: {
+        auto *n = static_cast<const Binary *>(node);
+        add({n->lhs, n->rhs});
+        break;
+    }
+    case ASTNode::CAST:
+        add({static_cast<const Cast *>(node)->expr});
+        break;
+    case ASTNode::ARRAY_NEW: {
+        auto *n = static_cast<const ArrayNew *>(node);
+        add({n->elemType, n->length});
+        break;
+    }
+    case ASTNode::INSTANCEOF:
+        add({static_cast<const Instanceof *>(node)->expr});
+        break;
+    default:
+        break;
+    }
+}
+
+// Names of the two trees are interned by different contexts, so their
+// pointers never match
+static bool sameName(Name a, Name b) { return a.getText() == b.getText(); }
+
+// The fields other than kind, pos and children, of nodes of the same kind
+static bool hasSameAttrs(const ASTNode *a, const ASTNode *b) {
+    switch (a->kind) {
+    case ASTNode::CLASS_DEF: {
+        auto *x = static_cast<const ClassDef *>(a);
+        auto *y = static_cast<const ClassDef *>(b);
+        return sameName(x->name, y->name) && sameName(x->baseName, y->baseName);
+    }
+    case ASTNode::METHOD_DEF: {
+        auto *x = static_cast<const MethodDef *>(a);
+        auto *y = static_cast<const MethodDef *>(b);
+        return x->isStatic == y->isStatic && sameName(x->name, y->name);
+    }
+    case ASTNode::VAR_DEF:
+        return sameName(static_cast<const VarDef *>(a)->name,
+                        static_cast<const VarDef *>(b)->name);
+    case ASTNode::TYPE_LIT: {
+        auto *x = static_cast<const TypeLit *>(a);
+        auto *y = static_cast<const TypeLit *>(b);
+        return x->base == y->base && sameName(x->className, y->className);
+    }
+    case ASTNode::LOCAL_VAR_DEF:
+        return static_cast<const LocalVarDef *>(a)->opPos ==
+               static_cast<const LocalVarDef *>(b)->opPos;
+    case ASTNode::ASSIGN:
+        return static_cast<const Assign *>(a)->opPos ==
+               static_cast<const Assign *>(b)->opPos;
+    case ASTNode::INT_LIT:
+        return static_cast<const IntLit *>(a)->value ==
+               static_cast<const IntLit *>(b)->value;
+    case ASTNode::BOOL_LIT:
+        return static_cast<const BoolLit *>(a)->value ==
+               static_cast<const BoolLit *>(b)->value;
+    case ASTNode::STRING_LIT:
+        return static_cast<const StringLit *>(a)->value ==
+               static_cast<const StringLit *>(b)->value;
+    case ASTNode::VAR_SEL: {
+        auto *x = static_cast<const VarSel *>(a);
+        auto *y = static_cast<const VarSel *>(b);
+        return sameName(x->name, y->name) && x->namePos == y->namePos;
+    }
+    case ASTNode::INDEX_SEL:
+        return static_cast<const IndexSel *>(a)->opPos ==
+               static_cast<const IndexSel *>(b)->opPos;
+    case ASTNode::CALL: {
+        auto *x = static_cast<const Call *>(a);
+        auto *y = static_cast<const Call *>(b);
+        return sameName(x->name, y->name) && x->namePos == y->namePos &&
+               x->lparenPos == y->lparenPos;
+    }
+    case ASTNode::UNARY:
+        return static_cast<const Unary *>(a)->op ==
+               static_cast<const Unary *>(b)->op;
+    case ASTNode::BINARY: {
+        auto *x = static_cast<const Binary *>(a);
+        auto *y = static_cast<const Binary *>(b);
+        return x->op == y->op && x->opPos == y->opPos;
+    }
+    case ASTNode::CAST: {
+        auto *x = static_cast<const Cast *>(a);
+        auto *y = static_cast<const Cast *>(b);
+        return sameName(x->className, y->className) &&
+               x->classPos == y->classPos;
+    }
+    case ASTNode::CLASS_NEW:
+        return sameName(static_cast<const ClassNew *>(a)->className,
+                        static_cast<const ClassNew *>(b)->className);
+    case ASTNode::INSTANCEOF: {
+        auto *x = static_cast<const Instanceof *>(a);
+        auto *y = static_cast<const Instanceof *>(b);
+        return sameName(x->className, y->className) &&
+               x->classPos == y->classPos;
+    }
+    default:
+        return true;
+    }
+}
+
+const ASTNode *findMismatch(const ASTNode *a, const ASTNode *b) {
+    if (!a || !b) {
+        return a ? a : b;
+    }
+    if (a->kind != b->kind || !(a->pos == b->pos) || !hasSameAttrs(a, b)) {
+        return a;
+    }
+
+    std::vector<const ASTNode *> aChildren, bChildren;
+    getChildren(a, aChildren);
+    getChildren(b, bChildren);
+    if (aChildren.size() != bChildren.size()) {
+        return a;
+    }
+    for (size_t i = 0; i < aChildren.size(); i++) {
+        if (const ASTNode *node = findMismatch(aChildren[i], bChildren[i])) {
+            return node;
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,10 @@
+#ifndef _AST_COMPARE_H_
+#define _AST_COMPARE_H_
+
+#include "AST.h"
+
+// First node, in preorder, where the trees differ in kind, position,
+// attributes or number of children. Null if they are equal
+const ASTNode *findMismatch(const ASTNode *a, const ASTNode *b);
+
+#endif
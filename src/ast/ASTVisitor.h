@@ -0,0 +1,252 @@
+#ifndef _AST_VISITOR_H_
+#define _AST_VISITOR_H_
+
+#include "AST.h"
+
+// Walks the AST with static dispatch. Derived passes itself as Derived and
+// hides the visit methods it cares about; the dispatching switches call
+// them directly, with no virtual call and no boxing of results. Expression
+// visits return ExprResult, everything else returns nothing. Unless hidden,
+// a visit method visits the node's children in source order, and for an
+// expression returns ExprResult()
+template <typename Derived, typename ExprResult = void> class ASTVisitor {
+public:
+    void visitTopLevel(TopLevel *node) {
+        for (ClassDef *c : node->classes) {
+            derived().visitClassDef(c);
+        }
+    }
+
+    void visitClassDef(ClassDef *node) {
+        for (ASTNode *f : node->fields) {
+            visitField(f);
+        }
+    }
+
+    // A VarDef or a MethodDef
+    void visitField(ASTNode *node) {
+        if (node->kind == ASTNode::METHOD_DEF) {
+            derived().visitMethodDef(static_cast<MethodDef *>(node));
+        } else {
+            derived().visitVarDef(static_cast<VarDef *>(node));
+        }
+    }
+
+    void visitMethodDef(MethodDef *node) {
+        for (VarDef *p : node->params) {
+            derived().visitVarDef(p);
+        }
+        derived().visitBlock(node->body);
+    }
+
+    void visitVarDef(VarDef *node) {}
+
+    void visitStmt(Stmt *node) {
+        switch (node->kind) {
+        case ASTNode::BLOCK:
+            return derived().visitBlock(static_cast<Block *>(node));
+        case ASTNode::LOCAL_VAR_DEF:
+            return derived().visitLocalVarDef(static_cast<LocalVarDef *>(node));
+        case ASTNode::ASSIGN:
+            return derived().visitAssign(static_cast<Assign *>(node));
+        case ASTNode::EXPR_STMT:
+            return derived().visitExprStmt(static_cast<ExprStmt *>(node));
+        case ASTNode::IF_STMT:
+            return derived().visitIfStmt(static_cast<IfStmt *>(node));
+        case ASTNode::WHILE_STMT:
+            return derived().visitWhileStmt(static_cast<WhileStmt *>(node));
+        case ASTNode::FOR_STMT:
+            return derived().visitForStmt(static_cast<ForStmt *>(node));
+        case ASTNode::BREAK_STMT:
+            return derived().visitBreakStmt(static_cast<BreakStmt *>(node));
+        case ASTNode::RETURN_STMT:
+            return derived().visitReturnStmt(static_cast<ReturnStmt *>(node));
+        case ASTNode::PRINT_STMT:
+            return derived().visitPrintStmt(static_cast<PrintStmt *>(node));
+        case ASTNode::EMPTY_STMT:
+            return derived().visitEmptyStmt(static_cast<EmptyStmt *>(node));
+        default:
+            return;
+        }
+    }
+
+    ExprResult visitExpr(Expr *node) {
+        switch (node->kind) {
+        case ASTNode::INT_LIT:
+            return derived().visitIntLit(static_cast<IntLit *>(node));
+        case ASTNode::BOOL_LIT:
+            return derived().visitBoolLit(static_cast<BoolLit *>(node));
+        case ASTNode::NULL_LIT:
+            return derived().visitNullLit(static_cast<NullLit *>(node));
+        case ASTNode::STRING_LIT:
+            return derived().visitStringLit(static_cast<StringLit *>(node));
+        case ASTNode::THIS_EXPR:
+            return derived().visitThisExpr(static_cast<ThisExpr *>(node));
+        case ASTNode::VAR_SEL:
+            return derived().visitVarSel(static_cast<VarSel *>(node));
+        case ASTNode::INDEX_SEL:
+            return derived().visitIndexSel(static_cast<IndexSel *>(node));
+        case ASTNode::CALL:
+            return derived().visitCall(static_cast<Call *>(node));
+        case ASTNode::PAREN:
+            return derived().visitParen(static_cast<Paren *>(node));
+        case ASTNode::UNARY:
+            return derived().visitUnary(static_cast<Unary *>(node));
+        case ASTNode::BINARY:
+            return derived().visitBinary(static_cast<Binary *>(node));
+        case ASTNode::CAST:
+            return derived().visitCast(static_cast<Cast *>(node));
+        case ASTNode::READ_INT:
+            return derived().visitReadInt(static_cast<ReadInt *>(node));
+        case ASTNode::READ_LINE:
+            return derived().visitReadLine(static_cast<ReadLine *>(node));
+        case ASTNode::CLASS_NEW:
+            return derived().visitClassNew(static_cast<ClassNew *>(node));
+        case ASTNode::ARRAY_NEW:
+            return derived().visitArrayNew(static_cast<ArrayNew *>(node));
+        case ASTNode::INSTANCEOF:
+            return derived().visitInstanceof(static_cast<Instanceof *>(node));
+        default:
+            return ExprResult();
+        }
+    }
+
+    // Statements
+
+    void visitBlock(Block *node) {
+        for (Stmt *s : node->stmts) {
+            visitStmt(s);
+        }
+    }
+
+    void visitLocalVarDef(LocalVarDef *node) {
+        derived().visitVarDef(node->var);
+        if (node->init) {
+            visitExpr(node->init);
+        }
+    }
+
+    void visitAssign(Assign *node) {
+        visitExpr(node->lValue);
+        visitExpr(node->expr);
+    }
+
+    void visitExprStmt(ExprStmt *node) { visitExpr(node->expr); }
+
+    void visitIfStmt(IfStmt *node) {
+        visitExpr(node->cond);
+        visitStmt(node->thenStmt);
+        if (node->elseStmt) {
+            visitStmt(node->elseStmt);
+        }
+    }
+
+    void visitWhileStmt(WhileStmt *node) {
+        visitExpr(node->cond);
+        visitStmt(node->body);
+    }
+
+    void visitForStmt(ForStmt *node) {
+        if (node->init) {
+            visitStmt(node->init);
+        }
+        visitExpr(node->cond);
+        if (node->update) {
+            visitStmt(node->update);
+        }
+        visitStmt(node->body);
+    }
+
+    void visitBreakStmt(BreakStmt *node) {}
+
+    void visitReturnStmt(ReturnStmt *node) {
+        if (node->expr) {
+            visitExpr(node->expr);
+        }
+    }
+
+    void visitPrintStmt(PrintStmt *node) {
+        for (Expr *e : node->args) {
+            visitExpr(e);
+        }
+    }
+
+    void visitEmptyStmt(EmptyStmt *node) {}
+
+    // Expressions
+
+    ExprResult visitIntLit(IntLit *node) { return ExprResult(); }
+
+    ExprResult visitBoolLit(BoolLit *node) { return ExprResult(); }
+
+    ExprResult visitNullLit(NullLit *node) { return ExprResult(); }
+
+    ExprResult visitStringLit(StringLit *node) { return ExprResult(); }
+
+    ExprResult visitThisExpr(ThisExpr *node) { return ExprResult(); }
+
+    ExprResult visitVarSel(VarSel *node) {
+        if (node->receiver) {
+            visitExpr(node->receiver);
+        }
+        return ExprResult();
+    }
+
+    ExprResult visitIndexSel(IndexSel *node) {
+        visitExpr(node->array);
+        visitExpr(node->index);
+        return ExprResult();
+    }
+
+    ExprResult visitCall(Call *node) {
+        if (node->receiver) {
+            visitExpr(node->receiver);
+        }
+        for (Expr *a : node->args) {
+            visitExpr(a);
+        }
+        return ExprResult();
+    }
+
+    ExprResult visitParen(Paren *node) {
+        visitExpr(node->expr);
+        return ExprResult();
+    }
+
+    ExprResult visitUnary(Unary *node) {
+        visitExpr(node->operand);
+        return ExprResult();
+    }
+
+    ExprResult visitBinary(Binary *node) {
+        visitExpr(node->lhs);
+        visitExpr(node->rhs);
+        return ExprResult();
+    }
+
+    ExprResult visitCast(Cast *node) {
+        visitExpr(node->expr);
+        return ExprResult();
+    }
+
+    ExprResult visitReadInt(ReadInt *node) { return ExprResult(); }
+
+    ExprResult visitReadLine(ReadLine *node) { return ExprResult(); }
+
+    ExprResult visitClassNew(ClassNew *node) { return ExprResult(); }
+
+    ExprResult visitArrayNew(ArrayNew *node) {
+        visitExpr(node->length);
+        return ExprResult();
+    }
+
+    ExprResult visitInstanceof(Instanceof *node) {
+        visitExpr(node->expr);
+        return ExprResult();
+    }
+
+private:
+    Derived &derived() { return *static_cast<Derived *>(this); }
+};
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef _NAME_H_
+#define _NAME_H_
+
+#include "llvm/ADT/StringRef.h"
+#include <functional>
+#include <ostream>
+#include <string>
+
+// An identifier interned by an ASTContext. The context keeps a single copy
+// of each distinct name, so the names of one compilation are equal exactly
+// when their text is the same pointer, which also serves as the name's id
+// for hashing. The default Name is empty and equal to no interned one.
+class Name {
+public:
+    Name() = default;
+
+    llvm::StringRef getText() const { return text; }
+    std::string str() const { return text.str(); }
+    bool empty() const { return text.empty(); }
+
+    bool operator==(Name other) const {
+        return text.data() == other.text.data();
+    }
+    bool operator!=(Name other) const { return !(*this == other); }
+
+    struct Hash {
+        std::size_t operator()(Name name) const noexcept {
+            return std::hash<const char *>{}(name.text.data());
+        }
+    };
+
+private:
+    friend class ASTContext;
+    explicit Name(llvm::StringRef text) : text(text) {}
+
+    llvm::StringRef text;
+};
+
+inline std::ostream &operator<<(std::ostream &os, Name name) {
+    return os.write(name.getText().data(), name.getText().size());
+}
+
+#endif
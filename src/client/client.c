@@ -0,0 +1,116 @@
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "server/protocol.h"
+
+// Thin client of `decaf --server=<socket>`:
+//   decafc <socket> [decaf options] files...
+// behaves like running decaf directly, but in the warm server
+
+static int sendRequest(int fd, const char *payload, uint32_t len) {
+    int fds[DECAF_PROTO_NFDS] = {STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO};
+    char control[CMSG_SPACE(sizeof(fds))];
+    struct iovec iov = {&len, sizeof(len)};
+    struct msghdr msg = {0};
+    struct cmsghdr *cmsg;
+
+    memset(control, 0, sizeof(control));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+    memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+
+    if (sendmsg(fd, &msg, 0) != sizeof(len)) {
+        return -1;
+    }
+    while (len > 0) {
+        ssize_t n = write(fd, payload, len);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return -1;
+        }
+        payload += n;
+        len -= n;
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    struct sockaddr_un addr = {0};
+    char cwd[PATH_MAX];
+    char *payload;
+    size_t len;
+    int32_t ret;
+    int fd;
+    int i;
+
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <socket> [decaf args...]\n", argv[0]);
+        return 1;
+    }
+    if (getcwd(cwd, sizeof(cwd)) == NULL) {
+        fprintf(stderr, "[error] getcwd %s\n", strerror(errno));
+        return 1;
+    }
+
+    // "<cwd>\0<arg1>\0<arg2>\0..."
+    len = strlen(cwd) + 1;
+    for (i = 2; i < argc; i++) {
+        len += strlen(argv[i]) + 1;
+    }
+    if (len > DECAF_PROTO_MAX_PAYLOAD) {
+        fprintf(stderr, "[error] command line too long\n");
+        return 1;
+    }
+    payload = malloc(len);
+    if (!payload) {
+        fprintf(stderr, "[error] alloc fail\n");
+        return 1;
+    }
+    len = 0;
+    strcpy(payload, cwd);
+    len += strlen(cwd) + 1;
+    for (i = 2; i < argc; i++) {
+        strcpy(payload + len, argv[i]);
+        len += strlen(argv[i]) + 1;
+    }
+
+    addr.sun_family = AF_UNIX;
+    if (strlen(argv[1]) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "[error] socket path too long %s\n", argv[1]);
+        return 1;
+    }
+    strcpy(addr.sun_path, argv[1]);
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        fprintf(stderr, "[error] fail to connect %s %s\n", argv[1],
+                strerror(errno));
+        return 1;
+    }
+
+    if (sendRequest(fd, payload, (uint32_t)len) != 0) {
+        fprintf(stderr, "[error] fail to send request %s\n", strerror(errno));
+        return 1;
+    }
+    free(payload);
+
+    if (recv(fd, &ret, sizeof(ret), MSG_WAITALL) != sizeof(ret)) {
+        fprintf(stderr, "[error] server closed the connection\n");
+        return 1;
+    }
+    close(fd);
+    return ret;
+}
@@ -1,33 +1,92 @@
 #include "CodeGen.h"
 #include "Constructor.h"
+#include "JITRunner.h"
+#include "Linker.h"
+#include "Optimizer.h"
 #include "Pos.h"
 #include "Type.h"
 #include "semantic/scope/FormalScope.h"
 #include "semantic/type/ArrayType.h"
 #include "semantic/type/BaseChecker.h"
+#include "utils/printer.h"
+#include "llvm/Analysis/ModuleSummaryAnalysis.h"
+#include "llvm/Analysis/ProfileSummaryInfo.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/IR/DataLayout.h"
 #include "llvm/IR/Function.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/PassTimingInfo.h"
 #include "llvm/IR/Verifier.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Host.h"
+#include "llvm/Support/SystemUtils.h"
+#include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_os_ostream.h"
 #include "llvm/Support/raw_ostream.h"
 
-CodeGenVisitor::CodeGenVisitor(antlr4::tree::ParseTree *ast,
-                               std::shared_ptr<Scope> &scope,
-                               std::shared_ptr<ASTAttrManager> &am) {
+static bool initNativeTarget() {
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+    return true;
+}
+
+void CodeGenVisitor::initLLVM() {
+    static bool targetReady = initNativeTarget();
+    (void)targetReady;
+}
+
+static llvm::CodeGenOpt::Level getCodeGenOptLevel(int optLevel) {
+    switch (optLevel) {
+    case 0:
+        return llvm::CodeGenOpt::None;
+    case 1:
+        return llvm::CodeGenOpt::Less;
+    case 3:
+        return llvm::CodeGenOpt::Aggressive;
+    default:
+        return llvm::CodeGenOpt::Default;
+    }
+}
+
+CodeGenVisitor::CodeGenVisitor(TopLevel *ast, CompileContext &cc,
+                               const CodeGenOptions &opts)
+    : tsContext(std::make_unique<llvm::LLVMContext>()),
+      context(*tsContext.getContext()) {
     this->ast = ast;
-    this->scope = scope;
-    this->global = scope;
-    this->cur = scope;
-    attrManager = am;
+    this->scope = cc.globalScope;
+    this->global = cc.globalScope;
+    this->cur = cc.globalScope;
+    attrManager = cc.attrManager;
+    baseChecker = &cc.baseChecker;
+    thisName = cc.ast.intern("this");
+    options = opts;
 
     module = new llvm::Module("my module", context);
     builder = new llvm::IRBuilder<>(context);
 
+    initLLVM();
+
     auto targetTriple = llvm::sys::getDefaultTargetTriple();
     module->setTargetTriple(targetTriple);
     targetSize = 64;
 
-    vtable = new VTable(module, builder);
+    // PIC, since the system linker produces PIE executables by default
+    std::string err;
+    const llvm::Target *target =
+        llvm::TargetRegistry::lookupTarget(targetTriple, err);
+    if (target != nullptr) {
+        targetMachine.reset(target->createTargetMachine(
+            targetTriple, "generic", "", llvm::TargetOptions(),
+            llvm::Reloc::PIC_, llvm::None,
+            getCodeGenOptLevel(options.optLevel)));
+    }
+    if (targetMachine) {
+        module->setDataLayout(targetMachine->createDataLayout());
+    }
+
+    vtable = new VTable(module, builder, baseChecker);
 }
 
 CodeGenVisitor::~CodeGenVisitor() {
@@ -36,48 +95,189 @@ CodeGenVisitor::~CodeGenVisitor() {
     delete module;
 }
 
-void CodeGenVisitor::codegen() {
-    visit(ast);
-    module->print(llvm::outs(), nullptr);
+bool CodeGenVisitor::codegen() {
+    bool broken;
+    {
+        TimeReport::Phase phase(options.timeReport, "IR generation");
+        visitTopLevel(ast);
+        llvm::raw_os_ostream os(getDiagnosticStream());
+        broken = llvm::verifyModule(*module, &os);
+    }
 
-    if (llvm::verifyModule(*module, &llvm::outs())) {
-        // return;
+    // Passes may crash on a broken module, only optimize a verified one.
+    // The lazy JIT optimizes each method when it is first called instead
+    bool lazy = options.emit == EMIT_JIT && options.lazyJIT;
+    if (!broken && !lazy) {
+        TimeReport::Phase phase(options.timeReport, "Optimization");
+        optimize();
     }
+
+    // For the JIT this includes running the program
+    TimeReport::Phase phase(options.timeReport, "Emission");
+    switch (options.emit) {
+    case EMIT_BC:
+        return !broken && emitBitcode(options.output);
+    case EMIT_OBJ:
+        return !broken && emitObject(options.output);
+    case EMIT_EXE:
+        return !broken && emitExecutable(options.output);
+    case EMIT_JIT:
+        return !broken && runJIT();
+    default:
+        // A broken module is still printed for debugging, but not cached
+        return emitIR(options.output) && !broken;
+    }
+}
+
+bool CodeGenVisitor::emitIR(const std::string &path) {
+    if (path.empty()) {
+        module->print(llvm::outs(), nullptr);
+        return true;
+    }
+
+    std::error_code ec;
+    llvm::raw_fd_ostream dest(path, ec, llvm::sys::fs::OF_Text);
+    if (ec) {
+        getDiagnosticStream() << "[error] fail to open " << path << " "
+                              << ec.message() << "\n";
+        return false;
+    }
+    module->print(dest, nullptr);
+    return true;
 }
 
-antlrcpp::Any
-CodeGenVisitor::visitTopLevel(DecafParserParser::TopLevelContext *ctx) {
+bool CodeGenVisitor::emitBitcode(const std::string &path) {
+    std::unique_ptr<llvm::raw_fd_ostream> file;
+    llvm::raw_ostream *os = &llvm::outs();
+
+    if (path.empty()) {
+        // Refuse to dump binary to a terminal
+        if (llvm::CheckBitcodeOutputToConsole(llvm::outs())) {
+            return false;
+        }
+    } else {
+        std::error_code ec;
+        file.reset(new llvm::raw_fd_ostream(path, ec, llvm::sys::fs::OF_None));
+        if (ec) {
+            getDiagnosticStream() << "[error] fail to open " << path << " "
+                                  << ec.message() << "\n";
+            return false;
+        }
+        os = file.get();
+    }
+
+    if (options.moduleSummary) {
+        llvm::ProfileSummaryInfo psi(*module);
+        llvm::ModuleSummaryIndex index =
+            llvm::buildModuleSummaryIndex(*module, nullptr, &psi);
+        llvm::WriteBitcodeToFile(*module, *os, false, &index, true);
+    } else {
+        llvm::WriteBitcodeToFile(*module, *os);
+    }
+    os->flush();
+    return true;
+}
+
+bool CodeGenVisitor::emitObject(const std::string &path) {
+    if (!targetMachine) {
+        getDiagnosticStream() << "[error] no native target for "
+                              << module->getTargetTriple() << "\n";
+        return false;
+    }
+
+    std::error_code ec;
+    llvm::raw_fd_ostream dest(path, ec, llvm::sys::fs::OF_None);
+    if (ec) {
+        getDiagnosticStream() << "[error] fail to open " << path << " "
+                              << ec.message() << "\n";
+        return false;
+    }
+
+    llvm::legacy::PassManager pm;
+    if (targetMachine->addPassesToEmitFile(pm, dest, nullptr,
+                                           llvm::CGFT_ObjectFile)) {
+        getDiagnosticStream()
+            << "[error] target can't emit an object file\n";
+        return false;
+    }
+    // Backend passes run in the legacy pass manager, timed by a global flag.
+    // The driver compiles one file at a time with -ftime-report, so no other
+    // thread uses the flag meanwhile
+    if (options.timeReport) {
+        llvm::TimePassesIsEnabled = true;
+    }
+    pm.run(*module);
+    if (options.timeReport) {
+        llvm::raw_os_ostream os(getDiagnosticStream());
+        llvm::reportAndResetTimings(&os);
+        llvm::TimePassesIsEnabled = false;
+    }
+    dest.flush();
+    return true;
+}
+
+// Emit a temporary object and link it against the runtime library
+bool CodeGenVisitor::emitExecutable(const std::string &path) {
+    llvm::SmallString<128> objPath;
+    std::error_code ec =
+        llvm::sys::fs::createTemporaryFile("decaf", "o", objPath);
+    if (ec) {
+        getDiagnosticStream() << "[error] fail to create temporary file "
+                              << ec.message() << "\n";
+        return false;
+    }
+
+    bool ok = emitObject(objPath.str().str()) &&
+              Linker::link(objPath.str().str(), path);
+    llvm::sys::fs::remove(objPath);
+    return ok;
+}
+
+void CodeGenVisitor::optimize() {
+    if (!options.timeReport) {
+        Optimizer::run(*module, options.optLevel, targetMachine.get());
+        return;
+    }
+    llvm::raw_os_ostream os(getDiagnosticStream());
+    Optimizer::run(*module, options.optLevel, targetMachine.get(), &os);
+}
+
+// Hand the module over to the JIT, it can't be used afterwards
+bool CodeGenVisitor::runJIT() {
+    llvm::orc::ThreadSafeModule tsm(std::unique_ptr<llvm::Module>(module),
+                                    tsContext);
+    module = nullptr;
+    if (options.lazyJIT) {
+        return JITRunner::runLazy(std::move(tsm), options.optLevel);
+    }
+    return JITRunner::run(std::move(tsm));
+}
+
+void CodeGenVisitor::visitTopLevel(TopLevel *node) {
     std::vector<std::shared_ptr<Symbol>> classes = cur->getOrderedSymbols();
     genClasses(classes);
     genBuiltInProtos();
     // generate the rests
-    visitChildren(ctx);
-    return nullptr;
+    ASTVisitor::visitTopLevel(node);
 }
 
-antlrcpp::Any
-CodeGenVisitor::visitClassDef(DecafParserParser::ClassDefContext *ctx) {
-    Pos pos = getClassPos(ctx);
-    cur = cur->enterScope(pos);
+void CodeGenVisitor::visitClassDef(ClassDef *node) {
+    cur = attrManager->getScope(node);
     curClass = cur->getSymbol();
-    visitChildren(ctx);
+    ASTVisitor::visitClassDef(node);
     cur = cur->exitScope();
-
-    return nullptr;
 }
 
-antlrcpp::Any
-CodeGenVisitor::visitMethodDef(DecafParserParser::MethodDefContext *ctx) {
-    std::string cname = cur->name;
+void CodeGenVisitor::visitMethodDef(MethodDef *node) {
+    Name cname = cur->name;
     std::shared_ptr<Type> classType = cur->getSymbol()->type;
-    Pos pos = getMethodPos(ctx);
 
-    cur = cur->enterScope(pos);
+    cur = attrManager->getScope(node);
     curMethod = cur->getSymbol();
 
     std::shared_ptr<FormalScope> fScope =
         std::static_pointer_cast<FormalScope>(cur);
-    std::string fname = fScope->name;
+    Name fname = fScope->name;
 
     // Start emiting
     llvm::Function *f = module->getFunction(VTable::getFuncName(cname, fname));
@@ -95,48 +295,26 @@ CodeGenVisitor::visitMethodDef(DecafParserParser::MethodDefContext *ctx) {
     }
 
     // Emit the body
-    visitChildren(ctx);
-    // BasicBlock must have a terminator
-    if (f->getReturnType()->isVoidTy()) {
+    visitBlock(node->body);
+    // BasicBlock must have a terminator, unless the body ended in 'return;'
+    if (f->getReturnType()->isVoidTy() &&
+        !builder->GetInsertBlock()->getTerminator()) {
         builder->CreateRetVoid();
     }
 
     cur = cur->exitScope();
-    return nullptr;
 }
 
-//     antlrcpp::Any CodeGenVisitor::visitField(DecafParserParser::FieldContext
-//     *ctx) {} antlrcpp::Any
-//     CodeGenVisitor::visitVarDef(DecafParserParser::VarDefContext *ctx) {}
-//     antlrcpp::Any
-//     CodeGenVisitor::visitMethodDef(DecafParserParser::MethodDefContext *ctx)
-//     {} antlrcpp::Any CodeGenVisitor::visitVar(DecafParserParser::VarContext
-//     *ctx) {} antlrcpp::Any
-//     CodeGenVisitor::visitParaVarDef(DecafParserParser::ParaVarDefContext
-//     *ctx) {} antlrcpp::Any
-//     CodeGenVisitor::visitVarList(DecafParserParser::VarListContext *ctx) {}
-//     antlrcpp::Any
-//     CodeGenVisitor::visitClassType(DecafParserParser::ClassTypeContext *ctx)
-//     {} antlrcpp::Any CodeGenVisitor::visitType(DecafParserParser::TypeContext
-//     *ctx) {}antlrcpp::Any
-//     CodeGenVisitor::visitForInit(DecafParserParser::ForInitContext *ctx) {}
-//     antlrcpp::Any
-//     CodeGenVisitor::visitForUpdate(DecafParserParser::ForUpdateContext *ctx)
-//     {}antlrcpp::Any
-//     CodeGenVisitor::visitForControl(DecafParserParser::ForControlContext
-//     *ctx) {}
-antlrcpp::Any
-CodeGenVisitor::visitLocalVarDef(DecafParserParser::LocalVarDefContext *ctx) {
-    std::string id = ctx->var()->id()->IDENTIFIER()->getSymbol()->getText();
-    std::shared_ptr<Symbol> varSym = cur->lookup(id);
+void CodeGenVisitor::visitLocalVarDef(LocalVarDef *node) {
+    std::shared_ptr<Symbol> varSym = cur->lookup(node->var->name);
     std::shared_ptr<Type> lt = varSym->type;
 
     llvm::Type *llvmlt = getLLVMType(lt);
     llvm::AllocaInst *alloca = builder->CreateAlloca(llvmlt);
     llvm::Value *initVal;
 
-    if (ctx->bop) {
-        initVal = visit(ctx->expr()).as<llvm::Value *>();
+    if (node->init) {
+        initVal = visitExpr(node->init);
     } else {
         initVal = getLLVMDefaultValue(lt);
     }
@@ -148,17 +326,14 @@ CodeGenVisitor::visitLocalVarDef(DecafParserParser::LocalVarDefContext *ctx) {
 
     llvm::Value *v = builder->CreateStore(initVal, alloca);
     attrManager->setSymbolLLVMValue(varSym, alloca);
-
-    return nullptr;
 }
 
-antlrcpp::Any
-CodeGenVisitor::visitAssign(DecafParserParser::AssignContext *ctx) {
-    llvm::Value *r = visit(ctx->expr()).as<llvm::Value *>();
-    llvm::Value *l = visit(ctx->lValue()).as<llvm::Value *>();
+void CodeGenVisitor::visitAssign(Assign *node) {
+    llvm::Value *r = visitExpr(node->expr);
+    llvm::Value *l = getLValue(node->lValue);
 
     // LLVM-IR is typed, so we need to manually cast for subtyping
-    Type::TypeKind tk = attrManager->getExprType(ctx->expr())->getKind();
+    Type::TypeKind tk = attrManager->getExprType(node->expr)->getKind();
     if (tk == Type::CLASS_TYPE || tk == Type::NULL_TYPE) {
         // LValue is always a LLVM pointer
         llvm::PointerType *pt = llvm::dyn_cast<llvm::PointerType>(l->getType());
@@ -166,13 +341,11 @@ CodeGenVisitor::visitAssign(DecafParserParser::AssignContext *ctx) {
     }
 
     builder->CreateStore(r, l);
-    return nullptr;
 }
 
-antlrcpp::Any
-CodeGenVisitor::visitIfStmt(DecafParserParser::IfStmtContext *ctx) {
+void CodeGenVisitor::visitIfStmt(IfStmt *node) {
     // Convert condition to a bool by comparing non-equal to 0
-    llvm::Value *condV = visit(ctx->expr()).as<llvm::Value *>();
+    llvm::Value *condV = visitExpr(node->cond);
     condV = builder->CreateICmpNE(condV, builder->getInt32(0), "ifcond");
 
     // Create blocks for the then and else cases.  Insert the 'then' block at
@@ -186,10 +359,10 @@ CodeGenVisitor::visitIfStmt(DecafParserParser::IfStmtContext *ctx) {
 
     // Emit then block
     builder->SetInsertPoint(thenBB);
-    visit(ctx->stmt(0));
+    visitStmt(node->thenStmt);
     // No br-instruction if 'then-statment' returns, as LLVM requires one
     // terminator in a basic block
-    if (!attrManager->getHasRet(ctx->stmt(0))) {
+    if (!attrManager->getHasRet(node->thenStmt)) {
         builder->CreateBr(mergeBB);
     }
     // Codegen of 'then' can change the current block, update thenBB for the PHI
@@ -199,9 +372,9 @@ CodeGenVisitor::visitIfStmt(DecafParserParser::IfStmtContext *ctx) {
     f->getBasicBlockList().push_back(elseBB);
     builder->SetInsertPoint(elseBB);
     // Every basic block must have only one terminator
-    if (ctx->ELSE()) {
-        visit(ctx->stmt(1));
-        if (!attrManager->getHasRet(ctx->stmt(1))) {
+    if (node->elseStmt) {
+        visitStmt(node->elseStmt);
+        if (!attrManager->getHasRet(node->elseStmt)) {
             builder->CreateBr(mergeBB);
         }
     } else {
@@ -211,16 +384,13 @@ CodeGenVisitor::visitIfStmt(DecafParserParser::IfStmtContext *ctx) {
     elseBB = builder->GetInsertBlock();
 
     // Emit merge block
-    if (!attrManager->getHasRet(ctx)) {
+    if (!attrManager->getHasRet(node)) {
         f->getBasicBlockList().push_back(mergeBB);
         builder->SetInsertPoint(mergeBB);
     }
-
-    return nullptr;
 }
 
-antlrcpp::Any
-CodeGenVisitor::visitWhileStmt(DecafParserParser::WhileStmtContext *ctx) {
+void CodeGenVisitor::visitWhileStmt(WhileStmt *node) {
     llvm::Function *f = builder->GetInsertBlock()->getParent();
 
     llvm::BasicBlock *inBB = llvm::BasicBlock::Create(context, "loopin", f);
@@ -234,14 +404,14 @@ CodeGenVisitor::visitWhileStmt(DecafParserParser::WhileStmtContext *ctx) {
     loopExits.push_back(outBB);
 
     // Convert condition to a bool by comparing non-equal to 0
-    llvm::Value *condV = visit(ctx->expr()).as<llvm::Value *>();
+    llvm::Value *condV = visitExpr(node->cond);
     condV = builder->CreateICmpNE(condV, builder->getInt32(0), "loopcond");
     builder->CreateCondBr(condV, bodyBB, outBB);
 
     // while-statment's body
     f->getBasicBlockList().push_back(bodyBB);
     builder->SetInsertPoint(bodyBB);
-    visit(ctx->stmt());
+    visitStmt(node->body);
     // Codegen of 'body' may change the current block
     bodyBB = builder->GetInsertBlock();
     builder->CreateBr(inBB);
@@ -251,13 +421,10 @@ CodeGenVisitor::visitWhileStmt(DecafParserParser::WhileStmtContext *ctx) {
     builder->SetInsertPoint(outBB);
 
     loopExits.pop_back();
-
-    return nullptr;
 }
 
-antlrcpp::Any
-CodeGenVisitor::visitForStmt(DecafParserParser::ForStmtContext *ctx) {
-    cur = cur->enterScope(getForPos(ctx));
+void CodeGenVisitor::visitForStmt(ForStmt *node) {
+    cur = attrManager->getScope(node);
 
     llvm::Function *f = builder->GetInsertBlock()->getParent();
 
@@ -265,9 +432,9 @@ CodeGenVisitor::visitForStmt(DecafParserParser::ForStmtContext *ctx) {
     llvm::BasicBlock *bodyBB = llvm::BasicBlock::Create(context, "loopbody");
     llvm::BasicBlock *outBB = llvm::BasicBlock::Create(context, "loopout");
 
-    DecafParserParser::ForControlContext *forControl = ctx->forControl();
-
-    visit(forControl->forInit());
+    if (node->init) {
+        visitStmt(node->init);
+    }
 
     // go into loop
     builder->CreateBr(inBB);
@@ -276,15 +443,17 @@ CodeGenVisitor::visitForStmt(DecafParserParser::ForStmtContext *ctx) {
     loopExits.push_back(outBB);
 
     // Convert condition to a bool by comparing non-equal to 0
-    llvm::Value *condV = visit(forControl->expr()).as<llvm::Value *>();
+    llvm::Value *condV = visitExpr(node->cond);
     condV = builder->CreateICmpNE(condV, builder->getInt32(0), "loopcond");
     builder->CreateCondBr(condV, bodyBB, outBB);
 
     // for-statment's body
     f->getBasicBlockList().push_back(bodyBB);
     builder->SetInsertPoint(bodyBB);
-    visit(ctx->stmt());
-    visit(forControl->forUpdate());
+    visitStmt(node->body);
+    if (node->update) {
+        visitStmt(node->update);
+    }
     // Codegen of 'body' may change the current block
     bodyBB = builder->GetInsertBlock();
     builder->CreateBr(inBB);
@@ -296,11 +465,9 @@ CodeGenVisitor::visitForStmt(DecafParserParser::ForStmtContext *ctx) {
     loopExits.pop_back();
 
     cur = cur->exitScope();
-    return nullptr;
 }
 
-antlrcpp::Any
-CodeGenVisitor::visitBreakStmt(DecafParserParser::BreakStmtContext *ctx) {
+void CodeGenVisitor::visitBreakStmt(BreakStmt *node) {
     llvm::BasicBlock *outBB = loopExits.back();
 
     llvm::Function *f = builder->GetInsertBlock()->getParent();
@@ -310,132 +477,205 @@ CodeGenVisitor::visitBreakStmt(DecafParserParser::BreakStmtContext *ctx) {
     // in one basic block
     llvm::BasicBlock *bb = llvm::BasicBlock::Create(context, "", f);
     builder->SetInsertPoint(bb);
-
-    return nullptr;
 }
 
-antlrcpp::Any
-CodeGenVisitor::visitReturnStmt(DecafParserParser::ReturnStmtContext *ctx) {
-    llvm::Value *v = visit(ctx->expr()).as<llvm::Value *>();
+void CodeGenVisitor::visitReturnStmt(ReturnStmt *node) {
+    if (!node->expr) {
+        builder->CreateRetVoid();
+        return;
+    }
+
+    llvm::Value *v = visitExpr(node->expr);
 
     if (llvm::PointerType::classof(v->getType())) {
         llvm::Function *f = builder->GetInsertBlock()->getParent();
         v = builder->CreatePointerCast(v, f->getReturnType());
     }
     builder->CreateRet(v);
-    return nullptr;
 }
 
-antlrcpp::Any
-CodeGenVisitor::visitPrintStmt(DecafParserParser::PrintStmtContext *ctx) {
-    for (auto &expr : ctx->exprList()->expr()) {
+void CodeGenVisitor::visitPrintStmt(PrintStmt *node) {
+    for (Expr *expr : node->args) {
         Type::TypeKind tk = attrManager->getExprType(expr)->getKind();
         if (tk == Type::INTEGER_TYPE) {
-            std::vector<llvm::Value *> argsV = {
-                visit(expr).as<llvm::Value *>()};
+            std::vector<llvm::Value *> argsV = {visitExpr(expr)};
             llvm::Function *f = module->getFunction("_dcf_PRINT_INT");
             builder->CreateCall(f, argsV);
         } else if (tk == Type::BOOL_TYPE) {
-            std::vector<llvm::Value *> argsV = {
-                visit(expr).as<llvm::Value *>()};
+            std::vector<llvm::Value *> argsV = {visitExpr(expr)};
             llvm::Function *f = module->getFunction("_dcf_PRINT_BOOL");
             builder->CreateCall(f, argsV);
         } else if (tk == Type::STRING_TYPE) {
-            std::vector<llvm::Value *> argsV = {
-                visit(expr).as<llvm::Value *>()};
+            std::vector<llvm::Value *> argsV = {visitExpr(expr)};
             llvm::Function *f = module->getFunction("_dcf_PRINT_STRING");
             builder->CreateCall(f, argsV);
         }
     }
-    return nullptr;
 }
 
-//     antlrcpp::Any
-//     CodeGenVisitor::visitEmptyStmt(DecafParserParser::EmptyStmtContext *ctx)
-//     {}
-
-// antlrcpp::Any CodeGenVisitor::visitLocalVarDefStmt(
-//     DecafParserParser::LocalVarDefStmtContext *ctx) {
-//     int a;
-//     return nullptr;
-// }
-
-// antlrcpp::Any
-//     CodeGenVisitor::visitAssignStmt(DecafParserParser::AssignStmtContext
-//     *ctx) {} antlrcpp::Any
-//     CodeGenVisitor::visitExprStmt(DecafParserParser::ExprStmtContext *ctx) {}
-//     antlrcpp::Any CodeGenVisitor::visitStmt(DecafParserParser::StmtContext
-//     *ctx) {}
-antlrcpp::Any CodeGenVisitor::visitBlock(DecafParserParser::BlockContext *ctx) {
-    Pos pos = getBlockPos(ctx);
-
-    cur = cur->enterScope(pos);
-    visitChildren(ctx);
+void CodeGenVisitor::visitBlock(Block *node) {
+    cur = attrManager->getScope(node);
+    ASTVisitor::visitBlock(node);
     cur = cur->exitScope();
-    return nullptr;
 }
-//     antlrcpp::Any
-//     CodeGenVisitor::visitBlockStmt(DecafParserParser::BlockStmtContext *ctx)
-//     {}
-
-antlrcpp::Any
-CodeGenVisitor::visitVarSelLValue(DecafParserParser::VarSelLValueContext *ctx) {
-    if (ctx->DOT()) {
-        return getVarSelValue(ctx->expr(), ctx->id(), true);
-    } else {
-        std::string varId = ctx->id()->IDENTIFIER()->getText();
-        Pos pos = getIdPos(ctx->id());
-        return getVarValue(varId, pos, true);
-    }
+
+llvm::Value *CodeGenVisitor::visitIntLit(IntLit *node) {
+    return builder->getInt32(node->value);
 }
 
-antlrcpp::Any CodeGenVisitor::visitIndexSelLValue(
-    DecafParserParser::IndexSelLValueContext *ctx) {
-    return getIndexSelValue(ctx->expr(0), ctx->expr(1), true);
+llvm::Value *CodeGenVisitor::visitBoolLit(BoolLit *node) {
+    int boolVal = node->value ? 1 : 0;
+    return builder->getInt32(boolVal);
 }
 
-antlrcpp::Any
-CodeGenVisitor::visitThisExpr(DecafParserParser::ThisExprContext *ctx) {
-    Pos pos = getThisPos(ctx);
-    return getVarValue("this", pos, false);
+llvm::Value *CodeGenVisitor::visitNullLit(NullLit *node) {
+    return llvm::ConstantPointerNull::get(llvm::Type::getInt8PtrTy(context));
 }
 
-antlrcpp::Any CodeGenVisitor::visitInstanceofExpr(
-    DecafParserParser::InstanceofExprContext *ctx) {
-    llvm::Value *objPtr = visit(ctx->expr()).as<llvm::Value *>();
-    std::string cname = ctx->id()->IDENTIFIER()->getText();
+llvm::Value *CodeGenVisitor::visitStringLit(StringLit *node) {
+    return builder->CreateGlobalStringPtr(node->value, "", 0, module);
+}
 
-    // cast the object to an array of i8*, vptr is the first element
-    llvm::Type *interTy = builder->getInt8PtrTy();
-    llvm::Value *i8pArr =
-        builder->CreatePointerCast(objPtr, interTy->getPointerTo());
-    // it points to the vptr
-    llvm::Value *vpptr = builder->CreateGEP(i8pArr, builder->getInt32(0));
-    llvm::Value *vptr = builder->CreateLoad(interTy, vpptr);
+llvm::Value *CodeGenVisitor::visitThisExpr(ThisExpr *node) {
+    return getVarValue(thisName, node->pos, false);
+}
 
-    return vtable->instanceOf(vptr, cname);
+llvm::Value *CodeGenVisitor::visitVarSel(VarSel *node) {
+    if (node->receiver) {
+        return getVarSelValue(node, false);
+    }
+    return getVarValue(node->name, node->namePos, false);
+}
+
+llvm::Value *CodeGenVisitor::visitIndexSel(IndexSel *node) {
+    return getIndexSelValue(node, false);
+}
+
+llvm::Value *CodeGenVisitor::visitCall(Call *node) {
+    return getVarCallValue(node);
+}
+
+llvm::Value *CodeGenVisitor::visitParen(Paren *node) {
+    return visitExpr(node->expr);
+}
+
+llvm::Value *CodeGenVisitor::visitUnary(Unary *node) {
+    llvm::Value *v = visitExpr(node->operand);
+    if (node->op == Unary::NEG) {
+        return builder->CreateNeg(v);
+    }
+    llvm::Value *condV = builder->CreateICmpEQ(v, builder->getInt32(1));
+    return builder->CreateSelect(condV, builder->getInt32(0),
+                                 builder->getInt32(1));
 }
 
-antlrcpp::Any CodeGenVisitor::visitLocalCallExpr(
-    DecafParserParser::LocalCallExprContext *ctx) {
-    return getVarCallValue(nullptr, ctx->id(), ctx->exprList());
+llvm::Value *CodeGenVisitor::visitBinary(Binary *node) {
+    if (node->op == Binary::AND || node->op == Binary::OR) {
+        return getLogicalValue(node);
+    }
+
+    Type::TypeKind type = attrManager->getExprType(node->lhs)->getKind();
+    llvm::Value *l = visitExpr(node->lhs);
+    llvm::Value *r = visitExpr(node->rhs);
+    llvm::Value *condV = nullptr;
+
+    switch (node->op) {
+    case Binary::MUL:
+        return builder->CreateMul(l, r);
+    case Binary::DIV:
+        return builder->CreateSDiv(l, r);
+    case Binary::MOD:
+        return builder->CreateSRem(l, r);
+    case Binary::ADD:
+        return builder->CreateAdd(l, r);
+    case Binary::SUB:
+        return builder->CreateSub(l, r);
+    case Binary::AND:
+    case Binary::OR:
+        llvm_unreachable("&& and || are short-circuited above");
+    case Binary::LE:
+        condV = builder->CreateICmpSLE(l, r);
+        break;
+    case Binary::LT:
+        condV = builder->CreateICmpSLT(l, r);
+        break;
+    case Binary::GE:
+        condV = builder->CreateICmpSGE(l, r);
+        break;
+    case Binary::GT:
+        condV = builder->CreateICmpSGT(l, r);
+        break;
+    case Binary::EQ:
+    case Binary::NE: {
+        bool eq = node->op == Binary::EQ;
+        if (type == Type::CLASS_TYPE || type == Type::ARRAY_TYPE) {
+            llvm::Value *ptrDiff = builder->CreatePtrDiff(l, r);
+            if (eq) {
+                condV = builder->CreateICmpEQ(ptrDiff, builder->getInt64(0));
+            } else {
+                condV = builder->CreateICmpNE(ptrDiff, builder->getInt64(0));
+            }
+        } else if (type == Type::STRING_TYPE) {
+            llvm::Value *cmpRes = compString(l, r);
+            if (eq) {
+                condV = builder->CreateICmpEQ(cmpRes, builder->getInt32(1));
+            } else {
+                condV = builder->CreateICmpEQ(cmpRes, builder->getInt32(0));
+            }
+        } else {
+            if (eq) {
+                condV = builder->CreateICmpEQ(l, r);
+            } else {
+                condV = builder->CreateICmpNE(l, r);
+            }
+        }
+        break;
+    }
+    }
+
+    return builder->CreateSelect(condV, builder->getInt32(1),
+                                 builder->getInt32(0));
 }
 
-// antlrcpp::Any
-//     CodeGenVisitor::visitLogicalAndExpr(DecafParserParser::LogicalAndExprContext
-//     *ctx) {}
-antlrcpp::Any
-CodeGenVisitor::visitUnarySubExpr(DecafParserParser::UnarySubExprContext *ctx) {
-    llvm::Value *v = visit(ctx->expr()).as<llvm::Value *>();
-    return builder->CreateNeg(v);
+// The right operand of && and || is only evaluated if the left one doesn't
+// decide the result already
+llvm::Value *CodeGenVisitor::getLogicalValue(Binary *node) {
+    bool isAnd = node->op == Binary::AND;
+    llvm::Value *l = visitExpr(node->lhs);
+    llvm::Value *condV =
+        builder->CreateICmpNE(l, builder->getInt32(0), "logiccond");
+
+    // Codegen of the left operand can change the current block
+    llvm::BasicBlock *lhsBB = builder->GetInsertBlock();
+    llvm::Function *f = lhsBB->getParent();
+    llvm::BasicBlock *rhsBB = llvm::BasicBlock::Create(context, "logicrhs", f);
+    llvm::BasicBlock *mergeBB = llvm::BasicBlock::Create(context, "logiccont");
+
+    if (isAnd) {
+        builder->CreateCondBr(condV, rhsBB, mergeBB);
+    } else {
+        builder->CreateCondBr(condV, mergeBB, rhsBB);
+    }
+
+    builder->SetInsertPoint(rhsBB);
+    llvm::Value *r = visitExpr(node->rhs);
+    rhsBB = builder->GetInsertBlock();
+    builder->CreateBr(mergeBB);
+
+    // bools are 0 or 1, the left operand alone gives 0 for && and 1 for ||
+    f->getBasicBlockList().push_back(mergeBB);
+    builder->SetInsertPoint(mergeBB);
+    llvm::PHINode *phi = builder->CreatePHI(builder->getInt32Ty(), 2);
+    phi->addIncoming(builder->getInt32(isAnd ? 0 : 1), lhsBB);
+    phi->addIncoming(r, rhsBB);
+    return phi;
 }
 
-antlrcpp::Any
-CodeGenVisitor::visitCastExpr(DecafParserParser::CastExprContext *ctx) {
-    llvm::Value *objPtr = visit(ctx->expr()).as<llvm::Value *>();
+llvm::Value *CodeGenVisitor::visitCast(Cast *node) {
+    llvm::Value *objPtr = visitExpr(node->expr);
     std::shared_ptr<ClassType> exprT = std::static_pointer_cast<ClassType>(
-        attrManager->getExprType(ctx->expr()));
-    std::string cname = ctx->id()->IDENTIFIER()->getText();
+        attrManager->getExprType(node->expr));
+    Name cname = node->className;
 
     // cast the object to an array of i8*, vptr is the first element
     llvm::Type *interTy = builder->getInt8PtrTy();
@@ -455,7 +695,8 @@ CodeGenVisitor::visitCastExpr(DecafParserParser::CastExprContext *ctx) {
     builder->CreateCondBr(condV, chkBB, outBB);
     // halt with error string
     builder->SetInsertPoint(chkBB);
-    std::string err = exprT->getName() + " cannot be cast to " + cname;
+    std::string err =
+        exprT->getName().str() + " cannot be cast to " + cname.str();
     llvm::Value *errStr = builder->CreateGlobalStringPtr(err, "", 0, module);
     llvm::Function *halt = module->getFunction("_dcf_HALT");
     builder->CreateCall(halt, {errStr});
@@ -465,16 +706,25 @@ CodeGenVisitor::visitCastExpr(DecafParserParser::CastExprContext *ctx) {
     builder->SetInsertPoint(outBB);
 
     llvm::Type *dstT =
-        llvm::StructType::getTypeByName(module->getContext(), cname)
+        llvm::StructType::getTypeByName(module->getContext(), cname.getText())
             ->getPointerTo();
     return builder->CreatePointerCast(objPtr, dstT);
 }
 
-antlrcpp::Any
-CodeGenVisitor::visitClassNewExpr(DecafParserParser::ClassNewExprContext *ctx) {
-    std::string cname = ctx->id()->IDENTIFIER()->getText();
+llvm::Value *CodeGenVisitor::visitReadInt(ReadInt *node) {
+    llvm::Function *f = module->getFunction("_dcf_READ_INT");
+    return builder->CreateCall(f);
+}
+
+llvm::Value *CodeGenVisitor::visitReadLine(ReadLine *node) {
+    llvm::Function *f = module->getFunction("_dcf_READ_LINE");
+    return builder->CreateCall(f);
+}
+
+llvm::Value *CodeGenVisitor::visitClassNew(ClassNew *node) {
+    Name cname = node->className;
     llvm::Type *ct =
-        llvm::StructType::getTypeByName(module->getContext(), cname);
+        llvm::StructType::getTypeByName(module->getContext(), cname.getText());
     llvm::DataLayout dl(module);
     uint64_t size = dl.getTypeAllocSize(ct);
 
@@ -492,50 +742,15 @@ CodeGenVisitor::visitClassNewExpr(DecafParserParser::ClassNewExprContext *ctx) {
     return castedMem;
 }
 
-// antlrcpp::Any
-//     CodeGenVisitor::visitReadLineExpr(DecafParserParser::ReadLineExprContext
-//     *ctx) {}
-
-antlrcpp::Any CodeGenVisitor::visitAddictiveExpr(
-    DecafParserParser::AddictiveExprContext *ctx) {
-    llvm::Value *l = visit(ctx->expr(0));
-    llvm::Value *r = visit(ctx->expr(1));
-    llvm::Value *result = nullptr;
-
-    if (ctx->ADD()) {
-        result = builder->CreateAdd(l, r);
-    } else if (ctx->SUB()) {
-        result = builder->CreateSub(l, r);
-    }
-    return result;
-}
-
-antlrcpp::Any
-CodeGenVisitor::visitIndexSelExpr(DecafParserParser::IndexSelExprContext *ctx) {
-    return getIndexSelValue(ctx->expr(0), ctx->expr(1), false);
-}
-
-// antlrcpp::Any
-//     CodeGenVisitor::visitParenExpr(DecafParserParser::ParenExprContext *ctx)
-//     {} antlrcpp::Any
-//     CodeGenVisitor::visitLogicalOrExpr(DecafParserParser::LogicalOrExprContext
-//     *ctx) {}
-
-antlrcpp::Any
-CodeGenVisitor::visitVarSelExpr(DecafParserParser::VarSelExprContext *ctx) {
-    return getVarSelValue(ctx->expr(), ctx->id(), false);
-}
-
-antlrcpp::Any
-CodeGenVisitor::visitArrayNewExpr(DecafParserParser::ArrayNewExprContext *ctx) {
+llvm::Value *CodeGenVisitor::visitArrayNew(ArrayNew *node) {
     std::shared_ptr<ArrayType> arrTy =
-        std::static_pointer_cast<ArrayType>(attrManager->getExprType(ctx));
+        std::static_pointer_cast<ArrayType>(attrManager->getExprType(node));
     llvm::Type *baseTy = getLLVMType(arrTy->getBase());
     llvm::DataLayout dl(module);
     llvm::Value *baseSize =
         builder->getIntN(targetSize, dl.getTypeAllocSize(baseTy));
 
-    llvm::Value *len = visit(ctx->expr()).as<llvm::Value *>();
+    llvm::Value *len = visitExpr(node->length);
 
     // Runtime Checking: Array's bounds checking
     checkArrayLen(len);
@@ -562,165 +777,25 @@ CodeGenVisitor::visitArrayNewExpr(DecafParserParser::ArrayNewExprContext *ctx) {
     return ptr;
 }
 
-// antlrcpp::Any
-//     CodeGenVisitor::visitReadIntExpr(DecafParserParser::ReadIntExprContext
-//     *ctx) {}
-
-antlrcpp::Any
-CodeGenVisitor::visitVarCallExpr(DecafParserParser::VarCallExprContext *ctx) {
-    return getVarCallValue(ctx->expr(), ctx->id(), ctx->exprList());
-}
-
-antlrcpp::Any
-CodeGenVisitor::visitUnaryNotExpr(DecafParserParser::UnaryNotExprContext *ctx) {
-    llvm::Value *v = visit(ctx->expr()).as<llvm::Value *>();
-    llvm::Value *condV = builder->CreateICmpEQ(v, builder->getInt32(1));
-    return builder->CreateSelect(condV, builder->getInt32(0),
-                                 builder->getInt32(1));
-}
-
-antlrcpp::Any CodeGenVisitor::visitMultiplicativeExpr(
-    DecafParserParser::MultiplicativeExprContext *ctx) {
-    llvm::Value *l = visit(ctx->expr(0));
-    llvm::Value *r = visit(ctx->expr(1));
-    llvm::Value *result = nullptr;
-
-    if (ctx->MUL()) {
-        result = builder->CreateMul(l, r);
-    } else if (ctx->DIV()) {
-        result = builder->CreateSDiv(l, r);
-    } else if (ctx->MOD()) {
-        result = builder->CreateSRem(l, r);
-    }
-    return result;
-}
-
-antlrcpp::Any
-CodeGenVisitor::visitRelationExpr(DecafParserParser::RelationExprContext *ctx) {
-    llvm::Value *l = visit(ctx->expr(0));
-    llvm::Value *r = visit(ctx->expr(1));
-    llvm::Value *condV = nullptr;
+llvm::Value *CodeGenVisitor::visitInstanceof(Instanceof *node) {
+    llvm::Value *objPtr = visitExpr(node->expr);
+    Name cname = node->className;
 
-    if (ctx->LE()) {
-        condV = builder->CreateICmpSLE(l, r);
-    } else if (ctx->LT()) {
-        condV = builder->CreateICmpSLT(l, r);
-    } else if (ctx->GE()) {
-        condV = builder->CreateICmpSGE(l, r);
-    } else if (ctx->GT()) {
-        condV = builder->CreateICmpSGT(l, r);
-    }
-    return builder->CreateSelect(condV, builder->getInt32(1),
-                                 builder->getInt32(0));
-}
-
-antlrcpp::Any
-CodeGenVisitor::visitEqualityExpr(DecafParserParser::EqualityExprContext *ctx) {
-    Type::TypeKind type = attrManager->getExprType(ctx->expr(0))->getKind();
-    llvm::Value *l = visit(ctx->expr(0));
-    llvm::Value *r = visit(ctx->expr(1));
-    llvm::Value *condV = nullptr;
-
-    if (type == Type::CLASS_TYPE || type == Type::ARRAY_TYPE) {
-        llvm::Value *ptrDiff = builder->CreatePtrDiff(l, r);
-        if (ctx->EQ()) {
-            condV = builder->CreateICmpEQ(ptrDiff, builder->getInt64(0));
-        } else if (ctx->NE()) {
-            condV = builder->CreateICmpNE(ptrDiff, builder->getInt64(0));
-        }
-    } else if (type == Type::STRING_TYPE) {
-        llvm::Value *cmpRes = compString(l, r);
-        if (ctx->EQ()) {
-            condV = builder->CreateICmpEQ(cmpRes, builder->getInt32(1));
-        } else if (ctx->NE()) {
-            condV = builder->CreateICmpEQ(cmpRes, builder->getInt32(0));
-        }
-    } else {
-        if (ctx->EQ()) {
-            condV = builder->CreateICmpEQ(l, r);
-        } else if (ctx->NE()) {
-            condV = builder->CreateICmpNE(l, r);
-        }
-    }
-
-    return builder->CreateSelect(condV, builder->getInt32(1),
-                                 builder->getInt32(0));
-}
-
-antlrcpp::Any
-CodeGenVisitor::visitIdExpr(DecafParserParser::IdExprContext *ctx) {
-    std::string name = ctx->id()->IDENTIFIER()->getText();
-    Pos pos = getIdPos(ctx->id());
-    return getVarValue(name, pos, false);
-}
-
-antlrcpp::Any
-CodeGenVisitor::visitIntLit(DecafParserParser::IntLitContext *ctx) {
-    std::string intText = ctx->INTLIT()->getText();
-    int intVal = std::stoi(intText);
-    return static_cast<llvm::Value *>(builder->getInt32(intVal));
-}
-
-antlrcpp::Any
-CodeGenVisitor::visitBoolLit(DecafParserParser::BoolLitContext *ctx) {
-    int boolVal = ctx->TRUE() ? 1 : 0;
-    return static_cast<llvm::Value *>(builder->getInt32(boolVal));
-}
-
-antlrcpp::Any
-CodeGenVisitor::visitNullLit(DecafParserParser::NullLitContext *ctx) {
-    return static_cast<llvm::Value *>(
-        llvm::ConstantPointerNull::get(llvm::Type::getInt8PtrTy(context)));
-}
-
-antlrcpp::Any
-CodeGenVisitor::visitStringLit(DecafParserParser::StringLitContext *ctx) {
-    std::string text = ctx->STRING_LIT()->getText();
-
-    // Replace escapes in string
-    size_t idx = 0;
-    while (true) {
-        idx = text.find("\\", idx);
-        if (idx == std::string::npos) {
-            break;
-        }
+    // cast the object to an array of i8*, vptr is the first element
+    llvm::Type *interTy = builder->getInt8PtrTy();
+    llvm::Value *i8pArr =
+        builder->CreatePointerCast(objPtr, interTy->getPointerTo());
+    // it points to the vptr
+    llvm::Value *vpptr = builder->CreateGEP(i8pArr, builder->getInt32(0));
+    llvm::Value *vptr = builder->CreateLoad(interTy, vpptr);
 
-        // Don't worry about bound-checking, as it is checked in lexer
-        char next = text[idx + 1];
-        if (next == '\\') {
-            text.replace(idx, 2, "\\");
-            idx += 2;
-        } else if (next == '\"') {
-            text.replace(idx, 2, "\"");
-            idx += 2;
-        } else if (next == 'n') {
-            text.replace(idx, 2, "\n");
-            idx += 2;
-        } else if (next == 't') {
-            text.replace(idx, 2, "\t");
-            idx += 2;
-        } else if (next == 'r') {
-            text.replace(idx, 2, "\r");
-            idx += 2;
-        } else {
-            // Wouldn't go here, already checked in lexer
-            idx++;
-        }
-    }
-    return static_cast<llvm::Value *>(
-        builder->CreateGlobalStringPtr(text, "", 0, module));
+    return vtable->instanceOf(vptr, cname);
 }
 
-//     antlrcpp::Any
-//     CodeGenVisitor::visitUnaryOp(DecafParserParser::UnaryOpContext *ctx) {}
-//     antlrcpp::Any
-//     CodeGenVisitor::visitExprList(DecafParserParser::ExprListContext *ctx) {}
-//     antlrcpp::Any CodeGenVisitor::visitId(DecafParserParser::IdContext *ctx)
-//     {}
-
 void CodeGenVisitor::genLLVMStruct(const std::shared_ptr<Symbol> &classSym) {
     llvm::StructType *ct =
-        llvm::StructType::getTypeByName(module->getContext(), classSym->name);
+        llvm::StructType::getTypeByName(module->getContext(),
+                                        classSym->name.getText());
     llvm::StructType *vtable = llvm::StructType::getTypeByName(
         module->getContext(), VTable::getVtableName(classSym->name));
 
@@ -733,18 +808,18 @@ void CodeGenVisitor::genLLVMStruct(const std::shared_ptr<Symbol> &classSym) {
     // 3. fields in this class
 
     // add base-class fields
-    std::string base = BaseChecker::getBase(classSym->name);
+    Name base = baseChecker->getBase(classSym->name);
     bool hasBase = !base.empty();
     if (hasBase) {
-        contents.push_back(
-            llvm::StructType::getTypeByName(module->getContext(), base));
+        contents.push_back(llvm::StructType::getTypeByName(
+            module->getContext(), base.getText()));
     } else {
         // ptr to vtable
         contents.push_back(builder->getInt8PtrTy());
     }
 
     // add fields
-    std::vector<std::string> methods;
+    std::vector<Name> methods;
     for (auto &field : fields) {
         if (field->getKind() == Symbol::VAR) {
             contents.push_back(getLLVMType(field->type));
@@ -769,9 +844,9 @@ llvm::Type *CodeGenVisitor::getLLVMType(const std::shared_ptr<Type> &t) {
     } else if (tk == Type::STRING_TYPE) {
         return builder->getInt8PtrTy();
     } else if (tk == Type::CLASS_TYPE) {
-        std::string name =
-            std::dynamic_pointer_cast<const ClassType>(t)->getName();
-        return llvm::StructType::getTypeByName(module->getContext(), name)
+        Name name = std::dynamic_pointer_cast<const ClassType>(t)->getName();
+        return llvm::StructType::getTypeByName(module->getContext(),
+                                               name.getText())
             ->getPointerTo();
     } else if (tk == Type::ARRAY_TYPE) {
         std::shared_ptr<Type> baseTy =
@@ -807,7 +882,7 @@ CodeGenVisitor::getLLVMDefaultValue(const std::shared_ptr<Type> &t) {
 void CodeGenVisitor::genClasses(
     const std::vector<std::shared_ptr<Symbol>> &classes) {
     for (auto &c : classes) {
-        llvm::StructType::create(context, llvm::StringRef(c->name));
+        llvm::StructType::create(context, c->name.getText());
         llvm::StructType::create(context, VTable::getVtableName(c->name));
     }
 
@@ -819,7 +894,7 @@ void CodeGenVisitor::genClasses(
     // Generate vtables of all classes
     vtable->generate(classes);
 
-    Constructor constr(module, builder, vtable);
+    Constructor constr(module, builder, vtable, baseChecker);
     for (auto &c : classes) {
         constr.generate(c->name);
     }
@@ -875,8 +950,8 @@ void CodeGenVisitor::genMethodProto(const std::shared_ptr<Symbol> &classSym,
         argTypes.push_back(getLLVMType(a));
     }
 
-    const std::string methodName = methodSym->name;
-    const std::string className = classSym->name;
+    Name methodName = methodSym->name;
+    Name className = classSym->name;
 
     llvm::FunctionType *ft = llvm::FunctionType::get(
         getLLVMType(type->getRetType()), argTypes, false);
@@ -887,14 +962,14 @@ void CodeGenVisitor::genMethodProto(const std::shared_ptr<Symbol> &classSym,
         VTable::getFuncName(className, methodName), module);
 }
 
-llvm::Value *CodeGenVisitor::getVarValue(const std::string &varId,
-                                         const Pos &pos, bool lValue) {
+llvm::Value *CodeGenVisitor::getVarValue(Name varId, const Pos &pos,
+                                         bool lValue) {
     std::shared_ptr<Symbol> sym = cur->lookupBefore(pos, varId);
     bool isField = sym->getParent()->kind == Scope::CLASS;
     llvm::Value *v = nullptr;
 
     if (isField) {
-        llvm::Value *thisPtr = getVarValue("this", pos, false);
+        llvm::Value *thisPtr = getVarValue(thisName, pos, false);
         v = getFieldPtr(sym, thisPtr);
     } else {
         // local variable or parameter
@@ -909,15 +984,12 @@ llvm::Value *CodeGenVisitor::getVarValue(const std::string &varId,
     }
 }
 
-llvm::Value *
-CodeGenVisitor::getIndexSelValue(DecafParserParser::ExprContext *varExpr,
-                                 DecafParserParser::ExprContext *idExpr,
-                                 bool lValue) {
-    llvm::Value *arrV = visit(varExpr).as<llvm::Value *>();
-    llvm::Value *idxV = visit(idExpr).as<llvm::Value *>();
+llvm::Value *CodeGenVisitor::getIndexSelValue(IndexSel *node, bool lValue) {
+    llvm::Value *arrV = visitExpr(node->array);
+    llvm::Value *idxV = visitExpr(node->index);
 
-    std::shared_ptr<ArrayType> arrTy =
-        std::static_pointer_cast<ArrayType>(attrManager->getExprType(varExpr));
+    std::shared_ptr<ArrayType> arrTy = std::static_pointer_cast<ArrayType>(
+        attrManager->getExprType(node->array));
     std::shared_ptr<Type> baseTy = arrTy->getBase();
 
     auto p = getArrayLength(arrV);
@@ -939,19 +1011,17 @@ CodeGenVisitor::getIndexSelValue(DecafParserParser::ExprContext *varExpr,
 
 // For 'expr.var', expr must be a object with class type T.
 // And you can only access it within the scope of T or its descendants
-llvm::Value *
-CodeGenVisitor::getVarSelValue(DecafParserParser::ExprContext *expr,
-                               DecafParserParser::IdContext *id, bool lValue) {
+llvm::Value *CodeGenVisitor::getVarSelValue(VarSel *node, bool lValue) {
     llvm::Value *v = nullptr;
-    std::string varId = id->IDENTIFIER()->getText();
+    Name varId = node->name;
 
-    std::shared_ptr<ClassType> exprTy =
-        std::static_pointer_cast<ClassType>(attrManager->getExprType(expr));
+    std::shared_ptr<ClassType> exprTy = std::static_pointer_cast<ClassType>(
+        attrManager->getExprType(node->receiver));
     std::shared_ptr<Scope> scope =
         global->lookup(exprTy->getName())->getScope();
     std::shared_ptr<Symbol> varSym = scope->lookup(varId);
 
-    llvm::Value *objPtr = visit(expr).as<llvm::Value *>();
+    llvm::Value *objPtr = visitExpr(node->receiver);
 
     v = getFieldPtr(varSym, objPtr);
 
@@ -963,23 +1033,32 @@ CodeGenVisitor::getVarSelValue(DecafParserParser::ExprContext *expr,
     }
 }
 
-llvm::Value *
-CodeGenVisitor::getVarCallValue(DecafParserParser::ExprContext *expr,
-                                DecafParserParser::IdContext *id,
-                                DecafParserParser::ExprListContext *exprList) {
-    std::string fname = id->IDENTIFIER()->getText();
+// Address of the left-hand side of an assignment
+llvm::Value *CodeGenVisitor::getLValue(Expr *node) {
+    if (node->kind == ASTNode::INDEX_SEL) {
+        return getIndexSelValue(static_cast<IndexSel *>(node), true);
+    }
+    auto *sel = static_cast<VarSel *>(node);
+    if (sel->receiver) {
+        return getVarSelValue(sel, true);
+    }
+    return getVarValue(sel->name, sel->namePos, true);
+}
+
+llvm::Value *CodeGenVisitor::getVarCallValue(Call *node) {
+    Name fname = node->name;
     llvm::Value *objPtr;
     std::shared_ptr<Type> exprTy;
 
-    if (expr) {
+    if (node->receiver) {
         // call method from a object
-        exprTy = attrManager->getExprType(expr);
+        exprTy = attrManager->getExprType(node->receiver);
 
-        if (attrManager->getIsClassName(expr)) {
+        if (attrManager->getIsClassName(node->receiver)) {
             // Call static method from other class
             objPtr = nullptr;
         } else {
-            objPtr = visit(expr).as<llvm::Value *>();
+            objPtr = visitExpr(node->receiver);
         }
     } else {
         // local call
@@ -988,16 +1067,16 @@ CodeGenVisitor::getVarCallValue(DecafParserParser::ExprContext *expr,
             // Call static method from self
             objPtr = nullptr;
         } else {
-            objPtr = getVarValue("this", getIdPos(id), false);
+            objPtr = getVarValue(thisName, node->namePos, false);
         }
     }
 
     // special case: array.length()
-    if (exprTy->getKind() == Type::ARRAY_TYPE && fname == "length") {
+    if (exprTy->getKind() == Type::ARRAY_TYPE && fname.getText() == "length") {
         return getArrayLength(objPtr).first;
     }
 
-    std::string cname = std::static_pointer_cast<ClassType>(exprTy)->getName();
+    Name cname = std::static_pointer_cast<ClassType>(exprTy)->getName();
     llvm::Value *fptr = getFunctionPtr(cname, fname, objPtr);
     llvm::FunctionType *ft =
         vtable->getFunction(cname, fname)->getFunctionType();
@@ -1011,9 +1090,9 @@ CodeGenVisitor::getVarCallValue(DecafParserParser::ExprContext *expr,
         argsV.push_back(castedObj);
     }
 
-    for (size_t i = 0; i < exprList->expr().size(); i++) {
+    for (size_t i = 0; i < node->args.size(); i++) {
         // LLVM-IR is typed, so we need to manually cast for subtyping
-        llvm::Value *v = visit(exprList->expr(i)).as<llvm::Value *>();
+        llvm::Value *v = visitExpr(node->args[i]);
         size_t idx = (objPtr ? 1 : 0) + i;
         if (llvm::PointerType::classof(ft->getParamType(idx))) {
             // Make argument's type the same with parameter's
@@ -1031,7 +1110,6 @@ CodeGenVisitor::getFieldPtr(const std::shared_ptr<Symbol> &fieldSym,
 
     std::shared_ptr<Scope> scope = fieldSym->getParent();
     auto fields = scope->getOrderedSymbols();
-    std::string name = fieldSym->name;
     int idx = 0;
 
     for (size_t i = 0; i < fields.size(); i++) {
@@ -1043,9 +1121,8 @@ CodeGenVisitor::getFieldPtr(const std::shared_ptr<Symbol> &fieldSym,
     // the first thing in a object is vptr or baseclass-part. Skip it
     idx += 1;
 
-    std::string cname = scope->name;
-    llvm::Type *ct =
-        llvm::StructType::getTypeByName(module->getContext(), cname);
+    llvm::Type *ct = llvm::StructType::getTypeByName(module->getContext(),
+                                                     scope->name.getText());
     llvm::Value *casted =
         builder->CreatePointerCast(objPtr, ct->getPointerTo());
     llvm::Value *fieldPtr = builder->CreateStructGEP(ct, casted, idx);
@@ -1056,8 +1133,7 @@ CodeGenVisitor::getFieldPtr(const std::shared_ptr<Symbol> &fieldSym,
 // Get the function pointer from a object's vtable.
 // When visit static function by class name(like MyClass.bar() ), objPtr is
 // nullptr
-llvm::Value *CodeGenVisitor::getFunctionPtr(const std::string &cname,
-                                            const std::string &fname,
+llvm::Value *CodeGenVisitor::getFunctionPtr(Name cname, Name fname,
                                             llvm::Value *objPtr) {
     if (!objPtr) {
         return module->getFunction(VTable::getFuncName(cname, fname));
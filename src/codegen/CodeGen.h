@@ -2,156 +2,111 @@
 #define _CODE_GEN_H_
 
 #include "VTable.h"
-#include "parser/antlr/DecafParserBaseVisitor.h"
+#include "ast/ASTVisitor.h"
 #include "semantic/Scope.h"
 #include "utils/ASTAttrManager.h"
+#include "utils/CompileContext.h"
+#include "utils/TimeReport.h"
+#include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
+#include "llvm/Target/TargetMachine.h"
 #include <memory>
 
-class CodeGenVisitor : public DecafParserBaseVisitor {
+// EMIT_JIT runs the program in-process instead of writing anything
+typedef enum { EMIT_LL, EMIT_BC, EMIT_OBJ, EMIT_EXE, EMIT_JIT } EmitKind;
+
+// Options controlling how the generated module is optimized and emitted
+struct CodeGenOptions {
+    // 0 ~ 3, same meaning as clang's -O0 ~ -O3
+    int optLevel = 0;
+    EmitKind emit = EMIT_LL;
+    // Attach a ThinLTO module summary to the bitcode
+    bool moduleSummary = false;
+    // With EMIT_JIT, lower and optimize each method on its first call
+    bool lazyJIT = false;
+    // Output path, textual IR and bitcode go to stdout if empty
+    std::string output;
+    // -ftime-report: phase timings go here, LLVM pass timers are printed
+    TimeReport *timeReport = nullptr;
+};
+
+class CodeGenVisitor : public ASTVisitor<CodeGenVisitor, llvm::Value *> {
 public:
-    CodeGenVisitor(antlr4::tree::ParseTree *ast, std::shared_ptr<Scope> &scope,
-                   std::shared_ptr<ASTAttrManager> &am);
+    CodeGenVisitor(TopLevel *ast, CompileContext &cc,
+                   const CodeGenOptions &opts);
     ~CodeGenVisitor();
 
-    void codegen();
+    // One-time LLVM target setup, done by the first instance otherwise
+    static void initLLVM();
 
-    virtual antlrcpp::Any
-    visitTopLevel(DecafParserParser::TopLevelContext *ctx) override;
-    virtual antlrcpp::Any
-    visitClassDef(DecafParserParser::ClassDefContext *ctx) override;
-    // virtual antlrcpp::Any visitField(DecafParserParser::FieldContext *ctx)
-    // override; virtual antlrcpp::Any
-    // visitVarDef(DecafParserParser::VarDefContext *ctx) override;
-    virtual antlrcpp::Any
-    visitMethodDef(DecafParserParser::MethodDefContext *ctx) override;
-    // virtual antlrcpp::Any visitVar(DecafParserParser::VarContext *ctx)
-    // override; virtual antlrcpp::Any
-    // visitParaVarDef(DecafParserParser::ParaVarDefContext *ctx) override;
-    // virtual antlrcpp::Any visitVarList(DecafParserParser::VarListContext
-    // *ctx) override; virtual antlrcpp::Any
-    // visitClassType(DecafParserParser::ClassTypeContext *ctx) override;
-    // virtual antlrcpp::Any visitType(DecafParserParser::TypeContext *ctx)
-    // override; virtual antlrcpp::Any
-    // visitForInit(DecafParserParser::ForInitContext *ctx) override; virtual
-    // antlrcpp::Any visitForUpdate(DecafParserParser::ForUpdateContext *ctx)
-    // override; virtual antlrcpp::Any
-    // visitForControl(DecafParserParser::ForControlContext *ctx) override;
-    virtual antlrcpp::Any
-    visitLocalVarDef(DecafParserParser::LocalVarDefContext *ctx) override;
-    virtual antlrcpp::Any
-    visitAssign(DecafParserParser::AssignContext *ctx) override;
-    virtual antlrcpp::Any
-    visitIfStmt(DecafParserParser::IfStmtContext *ctx) override;
-    virtual antlrcpp::Any
-    visitWhileStmt(DecafParserParser::WhileStmtContext *ctx) override;
+    bool codegen();
 
-    virtual antlrcpp::Any
-    visitForStmt(DecafParserParser::ForStmtContext *ctx) override;
-    virtual antlrcpp::Any
-    visitBreakStmt(DecafParserParser::BreakStmtContext *ctx) override;
-    virtual antlrcpp::Any
-    visitReturnStmt(DecafParserParser::ReturnStmtContext *ctx) override;
-    virtual antlrcpp::Any
-    visitPrintStmt(DecafParserParser::PrintStmtContext *ctx) override;
-    // virtual antlrcpp::Any visitEmptyStmt(DecafParserParser::EmptyStmtContext
-    // *ctx) override; virtual antlrcpp::Any
-    // visitLocalVarDefStmt(DecafParserParser::LocalVarDefStmtContext *ctx)
-    // override; virtual antlrcpp::Any
-    // visitAssignStmt(DecafParserParser::AssignStmtContext *ctx) override;
-    // virtual antlrcpp::Any visitExprStmt(DecafParserParser::ExprStmtContext
-    // *ctx) override; virtual antlrcpp::Any
-    // visitStmt(DecafParserParser::StmtContext *ctx) override;
-    virtual antlrcpp::Any
-    visitBlock(DecafParserParser::BlockContext *ctx) override;
-    // virtual antlrcpp::Any visitBlockStmt(DecafParserParser::BlockStmtContext
-    // *ctx) override;
-    virtual antlrcpp::Any
-    visitVarSelLValue(DecafParserParser::VarSelLValueContext *ctx) override;
-    virtual antlrcpp::Any
-    visitIndexSelLValue(DecafParserParser::IndexSelLValueContext *ctx) override;
+    void visitTopLevel(TopLevel *node);
+    void visitClassDef(ClassDef *node);
+    void visitMethodDef(MethodDef *node);
+    void visitLocalVarDef(LocalVarDef *node);
+    void visitAssign(Assign *node);
+    void visitIfStmt(IfStmt *node);
+    void visitWhileStmt(WhileStmt *node);
+    void visitForStmt(ForStmt *node);
+    void visitBreakStmt(BreakStmt *node);
+    void visitReturnStmt(ReturnStmt *node);
+    void visitPrintStmt(PrintStmt *node);
+    void visitBlock(Block *node);
 
-    virtual antlrcpp::Any
-    visitThisExpr(DecafParserParser::ThisExprContext *ctx) override;
-
-    virtual antlrcpp::Any
-    visitInstanceofExpr(DecafParserParser::InstanceofExprContext *ctx) override;
-    virtual antlrcpp::Any
-    visitLocalCallExpr(DecafParserParser::LocalCallExprContext *ctx) override;
-    // virtual antlrcpp::Any
-    // visitLogicalAndExpr(DecafParserParser::LogicalAndExprContext *ctx)
-    // override;
-    virtual antlrcpp::Any
-    visitUnarySubExpr(DecafParserParser::UnarySubExprContext *ctx) override;
-    virtual antlrcpp::Any visitCastExpr(DecafParserParser::CastExprContext
-    *ctx) override;
-    virtual antlrcpp::Any
-    visitClassNewExpr(DecafParserParser::ClassNewExprContext *ctx) override;
-    // virtual antlrcpp::Any
-    // visitReadLineExpr(DecafParserParser::ReadLineExprContext *ctx) override;
-    virtual antlrcpp::Any
-    visitAddictiveExpr(DecafParserParser::AddictiveExprContext *ctx) override;
-    virtual antlrcpp::Any
-    visitIndexSelExpr(DecafParserParser::IndexSelExprContext *ctx) override;
-    // virtual antlrcpp::Any visitParenExpr(DecafParserParser::ParenExprContext
-    // *ctx) override; virtual antlrcpp::Any
-    // visitLogicalOrExpr(DecafParserParser::LogicalOrExprContext *ctx)
-    // override;
-    virtual antlrcpp::Any
-    visitVarSelExpr(DecafParserParser::VarSelExprContext *ctx) override;
-    virtual antlrcpp::Any
-    visitArrayNewExpr(DecafParserParser::ArrayNewExprContext *ctx) override;
-    // virtual antlrcpp::Any
-    // visitReadIntExpr(DecafParserParser::ReadIntExprContext *ctx) override;
-    virtual antlrcpp::Any
-    visitVarCallExpr(DecafParserParser::VarCallExprContext *ctx) override;
-    // virtual antlrcpp::Any visitLitExpr(DecafParserParser::LitExprContext
-    // *ctx) override;
-    virtual antlrcpp::Any
-    visitUnaryNotExpr(DecafParserParser::UnaryNotExprContext *ctx) override;
-    virtual antlrcpp::Any visitMultiplicativeExpr(
-        DecafParserParser::MultiplicativeExprContext *ctx) override;
-    virtual antlrcpp::Any
-    visitRelationExpr(DecafParserParser::RelationExprContext *ctx) override;
-    virtual antlrcpp::Any
-    visitEqualityExpr(DecafParserParser::EqualityExprContext *ctx) override;
-    virtual antlrcpp::Any
-    visitIdExpr(DecafParserParser::IdExprContext *ctx) override;
-    virtual antlrcpp::Any
-    visitIntLit(DecafParserParser::IntLitContext *ctx) override;
-    virtual antlrcpp::Any
-    visitBoolLit(DecafParserParser::BoolLitContext *ctx) override;
-    virtual antlrcpp::Any
-    visitNullLit(DecafParserParser::NullLitContext *ctx) override;
-    virtual antlrcpp::Any
-    visitStringLit(DecafParserParser::StringLitContext *ctx) override;
-    // virtual antlrcpp::Any visitUnaryOp(DecafParserParser::UnaryOpContext
-    // *ctx) override; virtual antlrcpp::Any
-    // visitExprList(DecafParserParser::ExprListContext *ctx) override; virtual
-    // antlrcpp::Any visitId(DecafParserParser::IdContext *ctx) override;
+    llvm::Value *visitIntLit(IntLit *node);
+    llvm::Value *visitBoolLit(BoolLit *node);
+    llvm::Value *visitNullLit(NullLit *node);
+    llvm::Value *visitStringLit(StringLit *node);
+    llvm::Value *visitThisExpr(ThisExpr *node);
+    llvm::Value *visitVarSel(VarSel *node);
+    llvm::Value *visitIndexSel(IndexSel *node);
+    llvm::Value *visitCall(Call *node);
+    llvm::Value *visitParen(Paren *node);
+    llvm::Value *visitUnary(Unary *node);
+    llvm::Value *visitBinary(Binary *node);
+    llvm::Value *visitCast(Cast *node);
+    llvm::Value *visitReadInt(ReadInt *node);
+    llvm::Value *visitReadLine(ReadLine *node);
+    llvm::Value *visitClassNew(ClassNew *node);
+    llvm::Value *visitArrayNew(ArrayNew *node);
+    llvm::Value *visitInstanceof(Instanceof *node);
 
 private:
     // AST and symbol-table stuff
-    antlr4::tree::ParseTree *ast;
+    TopLevel *ast;
     std::shared_ptr<Scope> scope;
     std::shared_ptr<Scope> cur;
     std::shared_ptr<Scope> global;
     std::shared_ptr<ASTAttrManager> attrManager;
+    const BaseChecker *baseChecker;
     std::shared_ptr<Symbol> curClass;
     std::shared_ptr<Symbol> curMethod;
+    Name thisName;
+
+    CodeGenOptions options;
 
     // LLVM
     llvm::Module *module;
     llvm::IRBuilder<> *builder;
-    llvm::LLVMContext context;
+    // shared with the JIT, which owns the module together with its context
+    llvm::orc::ThreadSafeContext tsContext;
+    llvm::LLVMContext &context;
+    std::unique_ptr<llvm::TargetMachine> targetMachine;
     int targetSize;
     // for break-statment
     std::list<llvm::BasicBlock *> loopExits;
 
     VTable *vtable;
 
+    void optimize();
+    bool emitIR(const std::string &path);
+    bool emitBitcode(const std::string &path);
+    bool emitObject(const std::string &path);
+    bool emitExecutable(const std::string &path);
+    bool runJIT();
     void genLLVMStruct(const std::shared_ptr<Symbol> &classSym);
     void genClasses(const std::vector<std::shared_ptr<Symbol>> &classes);
     void genMethodProto(const std::shared_ptr<Symbol> &classSym,
@@ -159,20 +114,15 @@ private:
     void genBuiltInProtos();
     llvm::Type *getLLVMType(const std::shared_ptr<Type> &t);
     llvm::Value *getLLVMDefaultValue(const std::shared_ptr<Type> &t);
-    llvm::Value *getIndexSelValue(DecafParserParser::ExprContext *varExpr,
-                                  DecafParserParser::ExprContext *idExpr,
-                                  bool lValue);
-    llvm::Value *getVarValue(const std::string &varId, const Pos &pos,
-                             bool lValue);
-    llvm::Value *getVarSelValue(DecafParserParser::ExprContext *expr,
-                                DecafParserParser::IdContext *id, bool lValue);
-    llvm::Value *getVarCallValue(DecafParserParser::ExprContext *expr,
-                                 DecafParserParser::IdContext *id,
-                                 DecafParserParser::ExprListContext *exprList);
+    llvm::Value *getIndexSelValue(IndexSel *node, bool lValue);
+    llvm::Value *getVarValue(Name varId, const Pos &pos, bool lValue);
+    llvm::Value *getVarSelValue(VarSel *node, bool lValue);
+    llvm::Value *getLValue(Expr *node);
+    llvm::Value *getVarCallValue(Call *node);
+    llvm::Value *getLogicalValue(Binary *node);
     llvm::Value *getFieldPtr(const std::shared_ptr<Symbol> &fieldSym,
                              llvm::Value *objPtr);
-    llvm::Value *getFunctionPtr(const std::string &cname,
-                                const std::string &fname, llvm::Value *objPtr);
+    llvm::Value *getFunctionPtr(Name cname, Name fname, llvm::Value *objPtr);
     std::pair<llvm::Value *, llvm::Value *>
     getArrayLength(llvm::Value *arrayPtr);
     llvm::Value *compString(llvm::Value *s1, llvm::Value *s2);
@@ -3,17 +3,19 @@
 #include "llvm/IR/Function.h"
 #include "llvm/IR/Instructions.h"
 
-Constructor::Constructor(llvm::Module *m, llvm::IRBuilder<> *b, VTable *v) {
+Constructor::Constructor(llvm::Module *m, llvm::IRBuilder<> *b, VTable *v,
+                         const BaseChecker *bc) {
     module = m;
     builder = b;
     vtable = v;
+    baseChecker = bc;
 }
 
-std::string Constructor::getName(const std::string &cname) {
-    return std::string("_").append(cname).append(cname);
+std::string Constructor::getName(Name cname) {
+    return std::string("_").append(cname.str()).append(cname.str());
 }
 
-void Constructor::generate(const std::string &cname) {
+void Constructor::generate(Name cname) {
     std::string constrName = getName(cname);
 
     // Don't create it repeatedly
@@ -22,7 +24,8 @@ void Constructor::generate(const std::string &cname) {
     }
 
     llvm::StructType *st =
-        llvm::StructType::getTypeByName(module->getContext(), cname);
+        llvm::StructType::getTypeByName(module->getContext(),
+                                        cname.getText());
 
     std::vector<llvm::Type *> argTypes = {st->getPointerTo()};
     llvm::FunctionType *ft =
@@ -36,14 +39,15 @@ void Constructor::generate(const std::string &cname) {
     builder->SetInsertPoint(bb);
 
     // Call base's constructor first
-    std::string baseName = BaseChecker::getBase(cname);
+    Name baseName = baseChecker->getBase(cname);
     bool hasBase = !baseName.empty();
     if (hasBase) {
         generate(baseName);
 
         llvm::Function *baseConstr = module->getFunction(getName(baseName));
         llvm::Type *baseTy =
-            llvm::StructType::getTypeByName(module->getContext(), baseName);
+            llvm::StructType::getTypeByName(module->getContext(),
+                                            baseName.getText());
 
         
         llvm::Value *basePtr =
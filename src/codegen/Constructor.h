@@ -8,15 +8,19 @@
 #include "semantic/Symbol.h"
 #include "VTable.h"
 
+class BaseChecker;
+
 class Constructor {
 public:
-    Constructor(llvm::Module *m, llvm::IRBuilder<> *b, VTable *v);
-    static std::string getName(const std::string &cname);
-    void generate(const std::string &cname);
+    Constructor(llvm::Module *m, llvm::IRBuilder<> *b, VTable *v,
+                const BaseChecker *bc);
+    static std::string getName(Name cname);
+    void generate(Name cname);
 private:
     llvm::Module *module;
     llvm::IRBuilder<> *builder;
     VTable *vtable;
+    const BaseChecker *baseChecker;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,118 @@
+#include "JITRunner.h"
+#include "Optimizer.h"
+#include "runtime/runtime.h"
+#include "utils/printer.h"
+#include "llvm/ExecutionEngine/Orc/ExecutionUtils.h"
+#include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+
+static void reportError(llvm::Error err) {
+    getDiagnosticStream() << "[error] " << llvm::toString(std::move(err))
+                          << "\n";
+}
+
+bool JITRunner::run(llvm::orc::ThreadSafeModule tsm) {
+    auto jit = llvm::orc::LLJITBuilder().create();
+    if (!jit) {
+        reportError(jit.takeError());
+        return false;
+    }
+    if (!addRuntime(**jit)) {
+        return false;
+    }
+
+    if (llvm::Error err = (*jit)->addIRModule(std::move(tsm))) {
+        reportError(std::move(err));
+        return false;
+    }
+    return runMain(**jit);
+}
+
+bool JITRunner::runLazy(llvm::orc::ThreadSafeModule tsm, int optLevel) {
+    auto jtmb = llvm::orc::JITTargetMachineBuilder::detectHost();
+    if (!jtmb) {
+        reportError(jtmb.takeError());
+        return false;
+    }
+    auto tm = jtmb->createTargetMachine();
+    if (!tm) {
+        reportError(tm.takeError());
+        return false;
+    }
+    std::shared_ptr<llvm::TargetMachine> optTM = std::move(*tm);
+
+    auto jit = llvm::orc::LLLazyJITBuilder()
+                   .setJITTargetMachineBuilder(std::move(*jtmb))
+                   .create();
+    if (!jit) {
+        reportError(jit.takeError());
+        return false;
+    }
+    if (!addRuntime(**jit)) {
+        return false;
+    }
+
+    // One partition per requested function, optimized right before it is
+    // lowered
+    (*jit)->setPartitionFunction(
+        llvm::orc::CompileOnDemandLayer::compileRequested);
+    (*jit)->getIRTransformLayer().setTransform(
+        [optLevel, optTM](llvm::orc::ThreadSafeModule tsm,
+                          llvm::orc::MaterializationResponsibility &) {
+            tsm.withModuleDo([&](llvm::Module &m) {
+                Optimizer::run(m, optLevel, optTM.get());
+            });
+            return llvm::Expected<llvm::orc::ThreadSafeModule>(std::move(tsm));
+        });
+
+    if (llvm::Error err = (*jit)->addLazyIRModule(std::move(tsm))) {
+        reportError(std::move(err));
+        return false;
+    }
+    return runMain(**jit);
+}
+
+bool JITRunner::addRuntime(llvm::orc::LLJIT &jit) {
+    llvm::orc::JITDylib &jd = jit.getMainJITDylib();
+
+    // The runtime library is linked into decaf itself
+    llvm::orc::SymbolMap runtime;
+    auto addSymbol = [&](const char *name, void *addr) {
+        runtime[jit.mangleAndIntern(name)] = llvm::JITEvaluatedSymbol(
+            llvm::pointerToJITTargetAddress(addr),
+            llvm::JITSymbolFlags::Exported);
+    };
+    addSymbol("_dcf_ALLOCATE", (void *)&_dcf_ALLOCATE);
+    addSymbol("_dcf_READ_LINE", (void *)&_dcf_READ_LINE);
+    addSymbol("_dcf_READ_INT", (void *)&_dcf_READ_INT);
+    addSymbol("_dcf_STRING_EQUAL", (void *)&_dcf_STRING_EQUAL);
+    addSymbol("_dcf_PRINT_INT", (void *)&_dcf_PRINT_INT);
+    addSymbol("_dcf_PRINT_STRING", (void *)&_dcf_PRINT_STRING);
+    addSymbol("_dcf_PRINT_BOOL", (void *)&_dcf_PRINT_BOOL);
+    addSymbol("_dcf_HALT", (void *)&_dcf_HALT);
+    addSymbol("_dcf_rt_INSTANCE_OF", (void *)&_dcf_rt_INSTANCE_OF);
+    if (llvm::Error err = jd.define(llvm::orc::absoluteSymbols(runtime))) {
+        reportError(std::move(err));
+        return false;
+    }
+
+    // Anything else (libc) is resolved against the current process
+    auto gen = llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(
+        jit.getDataLayout().getGlobalPrefix());
+    if (!gen) {
+        reportError(gen.takeError());
+        return false;
+    }
+    jd.addGenerator(std::move(*gen));
+    return true;
+}
+
+bool JITRunner::runMain(llvm::orc::LLJIT &jit) {
+    auto mainSym = jit.lookup("main");
+    if (!mainSym) {
+        reportError(mainSym.takeError());
+        return false;
+    }
+    auto mainFn = (void (*)())mainSym->getAddress();
+    mainFn();
+    return true;
+}
@@ -0,0 +1,20 @@
+#ifndef _JIT_RUNNER_H_
+#define _JIT_RUNNER_H_
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
+
+// Compile a module in memory with ORC and run its main in-process
+class JITRunner {
+public:
+    // Compile the whole module up front
+    static bool run(llvm::orc::ThreadSafeModule tsm);
+    // Compile and optimize each function when it is first called, calls and
+    // vtable slots go through lazy-reexport stubs until then
+    static bool runLazy(llvm::orc::ThreadSafeModule tsm, int optLevel);
+
+private:
+    static bool addRuntime(llvm::orc::LLJIT &jit);
+    static bool runMain(llvm::orc::LLJIT &jit);
+};
+
+#endif
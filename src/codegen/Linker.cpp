@@ -0,0 +1,46 @@
+#include "Linker.h"
+#include "utils/printer.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/Program.h"
+
+#define RUNTIME_LIB "libdecafrt.a"
+
+std::string Linker::getRuntimePath() {
+    std::string exePath = llvm::sys::fs::getMainExecutable(
+        nullptr, (void *)(intptr_t)&Linker::getRuntimePath);
+    llvm::SmallString<128> path(llvm::sys::path::parent_path(exePath));
+    llvm::sys::path::append(path, RUNTIME_LIB);
+    return path.str().str();
+}
+
+bool Linker::link(const std::string &obj, const std::string &exe) {
+    llvm::ErrorOr<std::string> cc = llvm::sys::findProgramByName("cc");
+    if (!cc) {
+        getDiagnosticStream()
+            << "[error] can't find the system linker driver cc\n";
+        return false;
+    }
+
+    std::string runtime = getRuntimePath();
+    if (!llvm::sys::fs::exists(runtime)) {
+        getDiagnosticStream() << "[error] can't find runtime library "
+                              << runtime << "\n";
+        return false;
+    }
+
+    std::string errMsg;
+    llvm::StringRef args[] = {*cc, obj, runtime, "-o", exe};
+    int ret = llvm::sys::ExecuteAndWait(*cc, args, llvm::None, {}, 0, 0,
+                                        &errMsg);
+    if (ret != 0) {
+        std::ostream &diag = getDiagnosticStream();
+        diag << "[error] link " << exe << " failed";
+        if (!errMsg.empty()) {
+            diag << ": " << errMsg;
+        }
+        diag << "\n";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,13 @@
+#ifndef _LINKER_H_
+#define _LINKER_H_
+#include <string>
+
+// Link objects into an executable with the system C compiler driver, the
+// runtime library is expected next to the decaf binary
+class Linker {
+public:
+    static bool link(const std::string &obj, const std::string &exe);
+    static std::string getRuntimePath();
+};
+
+#endif
@@ -0,0 +1,56 @@
+#include "Optimizer.h"
+#include "utils/printer.h"
+#include "llvm/IR/PassInstrumentation.h"
+#include "llvm/IR/PassTimingInfo.h"
+#include "llvm/Passes/PassBuilder.h"
+#include "llvm/Support/raw_ostream.h"
+
+// "default<On>" is what clang uses for -On: SROA/mem2reg, instcombine, GVN,
+// LICM, the inliner and the loop passes
+void Optimizer::run(llvm::Module &m, int optLevel, llvm::TargetMachine *tm,
+                    llvm::raw_ostream *timeOut) {
+    if (optLevel == 0) {
+        return;
+    }
+
+    // Declared in this order so that they are destroyed in the reverse one
+    llvm::LoopAnalysisManager lam;
+    llvm::FunctionAnalysisManager fam;
+    llvm::CGSCCAnalysisManager cgam;
+    llvm::ModuleAnalysisManager mam;
+    llvm::PassBuilder pb;
+    llvm::PassInstrumentationCallbacks pic;
+    // reports when destroyed, after the pipeline has run
+    llvm::TimePassesHandler passTimers(timeOut != nullptr);
+    if (timeOut) {
+        passTimers.setOutStream(*timeOut);
+    }
+
+    // Instrumentation is registered like any other analysis, ours comes
+    // first so the PassBuilder's default is ignored
+    passTimers.registerCallbacks(pic);
+    lam.registerPass([&] { return llvm::PassInstrumentationAnalysis(&pic); });
+    fam.registerPass([&] { return llvm::PassInstrumentationAnalysis(&pic); });
+    cgam.registerPass([&] { return llvm::PassInstrumentationAnalysis(&pic); });
+    mam.registerPass([&] { return llvm::PassInstrumentationAnalysis(&pic); });
+
+    // Cost models of the real target, must be registered before the defaults
+    if (tm != nullptr) {
+        fam.registerPass([&] { return tm->getTargetIRAnalysis(); });
+    }
+    pb.registerModuleAnalyses(mam);
+    pb.registerCGSCCAnalyses(cgam);
+    pb.registerFunctionAnalyses(fam);
+    pb.registerLoopAnalyses(lam);
+    pb.crossRegisterProxies(lam, fam, cgam, mam);
+
+    llvm::ModulePassManager mpm;
+    std::string pipeline =
+        std::string("default<O").append(std::to_string(optLevel)).append(">");
+    if (llvm::Error err = pb.parsePassPipeline(mpm, pipeline)) {
+        getDiagnosticStream() << "[error] " << llvm::toString(std::move(err))
+                              << "\n";
+        return;
+    }
+    mpm.run(m, mam);
+}
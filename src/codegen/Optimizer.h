@@ -0,0 +1,16 @@
+#ifndef _OPTIMIZER_H_
+#define _OPTIMIZER_H_
+#include "llvm/IR/Module.h"
+#include "llvm/Target/TargetMachine.h"
+
+// Runs the standard LLVM pipeline of a given level on a module, shared by
+// the whole-module path and the per-method lazy JIT
+class Optimizer {
+public:
+    // LLVM's per-pass timers are printed to timeOut, if given, once the
+    // pipeline is done
+    static void run(llvm::Module &m, int optLevel, llvm::TargetMachine *tm,
+                    llvm::raw_ostream *timeOut = nullptr);
+};
+
+#endif
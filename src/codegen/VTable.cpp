@@ -2,7 +2,8 @@
 #include "semantic/type/BaseChecker.h"
 #include "llvm/IR/Constants.h"
 
-VTable::VTable(llvm::Module *m, llvm::IRBuilder<> *b) : module(m), builder(b) {}
+VTable::VTable(llvm::Module *m, llvm::IRBuilder<> *b, const BaseChecker *bc)
+    : module(m), builder(b), baseChecker(bc) {}
 
 void VTable::generate(const std::vector<std::shared_ptr<Symbol>> &classes) {
     methodMap methods = getMethodMap(classes);
@@ -12,8 +13,7 @@ void VTable::generate(const std::vector<std::shared_ptr<Symbol>> &classes) {
     }
 }
 
-llvm::Function *VTable::getFunction(const std::string &cname,
-                                    const std::string &fname) {
+llvm::Function *VTable::getFunction(Name cname, Name fname) {
     // should use map for better performance...
     llvmFunVec &methods = funsVec.find(cname)->second;
 
@@ -25,8 +25,7 @@ llvm::Function *VTable::getFunction(const std::string &cname,
     return nullptr;
 }
 
-llvm::Value *VTable::getFunctionPtr(const std::string &cname,
-                                    const std::string &fname,
+llvm::Value *VTable::getFunctionPtr(Name cname, Name fname,
                                     llvm::Value *vtablePtr) {
     int idx = 0;
     llvm::Function *f = nullptr;
@@ -56,7 +55,7 @@ llvm::Value *VTable::getFunctionPtr(const std::string &cname,
     return fp;
 }
 
-llvm::Value *VTable::instanceOf(llvm::Value *vptr, const std::string &cname) {
+llvm::Value *VTable::instanceOf(llvm::Value *vptr, Name cname) {
     llvm::Value *dstVtbl = module->getNamedGlobal(getVtableName(cname));
 
     llvm::Type *compTy = builder->getInt8PtrTy();
@@ -67,16 +66,15 @@ llvm::Value *VTable::instanceOf(llvm::Value *vptr, const std::string &cname) {
     return builder->CreateCall(f, {vptr, dstVtbl});
 }
 
-std::string VTable::getVtableName(const std::string &cname) {
-    return std::string(cname).append("Vtable");
+std::string VTable::getVtableName(Name cname) {
+    return cname.str().append("Vtable");
 }
 
-std::string VTable::getFuncName(const std::string &cname,
-                                const std::string &fname) {
-    if (cname == "Main" && fname == "main") {
-        return fname;
+std::string VTable::getFuncName(Name cname, Name fname) {
+    if (cname.getText() == "Main" && fname.getText() == "main") {
+        return fname.str();
     } else {
-        return std::string(cname).append("_").append(fname);
+        return cname.str().append("_").append(fname.getText().str());
     }
 }
 
@@ -85,22 +83,20 @@ VTable::getMethodMap(const std::vector<std::shared_ptr<Symbol>> &classes) {
     methodMap mmap;
 
     for (auto &c : classes) {
-        std::vector<std::string> ms;
-        const std::string cname = c->name;
+        std::vector<Name> ms;
+        Name cname = c->name;
 
         for (auto &field : c->getScope()->getOrderedSymbols()) {
             if (field->getKind() == Symbol::METHOD) {
                 ms.push_back(field->name);
             }
         }
-        std::pair<std::string, std::vector<std::string>> pair = {cname, ms};
-        mmap.insert(pair);
+        mmap.emplace(cname, std::move(ms));
     }
     return mmap;
 }
 
-llvmFunVec VTable::generate(const methodMap &mmap,
-                            const std::string className) {
+llvmFunVec VTable::generate(const methodMap &mmap, Name className) {
     // avoid creating same vtable again
     auto it = funsVec.find(className);
     if (it != funsVec.end()) {
@@ -108,7 +104,7 @@ llvmFunVec VTable::generate(const methodMap &mmap,
     }
 
     // get its base-class's virtual method table
-    std::string basename = BaseChecker::getBase(className);
+    Name basename = baseChecker->getBase(className);
     llvmFunVec parentMethodTable;
     if (!basename.empty()) {
         parentMethodTable = generate(mmap, basename);
@@ -116,10 +112,10 @@ llvmFunVec VTable::generate(const methodMap &mmap,
 
     // fill the virtual method table with its parent's one
     llvmFunVec curFunVec = parentMethodTable;
-    const std::vector<std::string> methods = mmap.find(className)->second;
+    const std::vector<Name> &methods = mmap.find(className)->second;
 
     // replace overrided methods. add additional method
-    for (const std::string &mName : methods) {
+    for (Name mName : methods) {
         llvm::Function *f = module->getFunction(getFuncName(className, mName));
         bool replaced = false;
 
@@ -131,8 +127,7 @@ llvmFunVec VTable::generate(const methodMap &mmap,
             }
         }
         if (!replaced) {
-            std::pair<std::string, llvm::Function *> p = {mName, f};
-            curFunVec.push_back(p);
+            curFunVec.emplace_back(mName, f);
         }
     }
 
@@ -167,12 +162,12 @@ llvmFunVec VTable::generate(const methodMap &mmap,
 
     // 2. pointer to a string of this class's name
     llvm::Constant *cnameVar = builder->CreateGlobalStringPtr(
-        className, std::string(className).append("Name"), 0, module);
+        className.getText(), className.str().append("Name"), 0, module);
     contents.push_back(cnameVar->getType());
     initVals.push_back(cnameVar);
 
     // 3. pointers to non-static methods
-    for (std::pair<std::string, llvm::Function *> &item : curFunVec) {
+    for (std::pair<Name, llvm::Function *> &item : curFunVec) {
         contents.push_back(item.second->getType());
         initVals.push_back(item.second);
     }
@@ -185,7 +180,6 @@ llvmFunVec VTable::generate(const methodMap &mmap,
     llvm::GlobalVariable *vtblVar = module->getNamedGlobal(vtblName);
     vtblVar->setInitializer(llvm::ConstantStruct::get(vtbl, initVals));
 
-    std::pair<std::string, llvmFunVec> p = {className, curFunVec};
-    funsVec.insert(p);
+    funsVec.emplace(className, curFunVec);
     return curFunVec;
 }
@@ -7,34 +7,34 @@
 #include "llvm/IR/Function.h"
 #include "llvm/IR/Module.h"
 
-using methodMap = std::unordered_map<std::string, std::vector<std::string>>;
-using llvmFunVec = std::vector<std::pair<std::string, llvm::Function*>>;
+using methodMap = std::unordered_map<Name, std::vector<Name>, Name::Hash>;
+using llvmFunVec = std::vector<std::pair<Name, llvm::Function*>>;
+
+class BaseChecker;
 
 class VTable {
 public:
-    VTable(llvm::Module *m, llvm::IRBuilder<> *b);
+    VTable(llvm::Module *m, llvm::IRBuilder<> *b, const BaseChecker *bc);
     void generate(const std::vector<std::shared_ptr<Symbol>> &classes);
-    llvm::Function *getFunction(const std::string &cname,
-                                const std::string &fname);
-    llvm::Value *getFunctionPtr(const std::string &cname,
-                                const std::string &fname,
+    llvm::Function *getFunction(Name cname, Name fname);
+    llvm::Value *getFunctionPtr(Name cname, Name fname,
                                 llvm::Value *vtablePtr);
-    llvm::Value *instanceOf(llvm::Value *vptr, const std::string &cname);
-    static std::string getVtableName(const std::string &cname);
-    static std::string getFuncName(const std::string &cname,
-                                   const std::string &fname);
+    llvm::Value *instanceOf(llvm::Value *vptr, Name cname);
+    static std::string getVtableName(Name cname);
+    static std::string getFuncName(Name cname, Name fname);
 
 private:
     
     // LLVM
     llvm::Module *module;
     llvm::IRBuilder<> *builder;
+    const BaseChecker *baseChecker;
 
-    std::unordered_map<std::string, llvmFunVec> funsVec;
+    std::unordered_map<Name, llvmFunVec, Name::Hash> funsVec;
 
     methodMap getMethodMap(const std::vector<std::shared_ptr<Symbol>> &classes);
 
-    llvmFunVec generate(const methodMap &mmap, const std::string className);
+    llvmFunVec generate(const methodMap &mmap, Name className);
 };
 
 #endif
\ No newline at end of file
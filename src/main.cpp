@@ -1,112 +1,708 @@
+#include <atomic>
 #include <cstring>
 #include <fstream>
+#include <getopt.h>
 #include <iostream>
 #include <memory>
+#include <sstream>
+#include <thread>
 #include <unistd.h>
 
 #include "DecafParserBaseListener.h"
 #include "DecafParserParser.h"
 #include "antlr4-runtime.h"
+#include "ast/ASTCompare.h"
 #include "codegen/CodeGen.h"
+#include "parser/ASTBuilder.h"
 #include "parser/ASTPrinter.h"
 #include "parser/CommonLexer.h"
+#include "parser/DFACache.h"
+#include "parser/DecisionProfile.h"
+#include "parser/DescentParser.h"
+#include "parser/DiagErrorListener.h"
+#include "parser/Utf8CharStream.h"
 #include "semantic/SymbolChecker.h"
 #include "semantic/TypeChecker.h"
+#include "server/Server.h"
 #include "utils/ASTAttrManager.h"
+#include "utils/CompileCache.h"
+#include "utils/CompileContext.h"
+#include "utils/TimeReport.h"
 #include "utils/printer.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
 
 using namespace std;
 using namespace antlr4;
 
-typedef enum { NO_TASK, PA1_TASK, PA2_TASK, PA3_TASK } PATASK;
+typedef enum { NO_TASK, PA1_TASK, PA2_TASK, PA3_TASK, RUN_TASK } PATASK;
 
-static int optHandle(int argc, char *const *argv, PATASK &task, string &file) {
+// --parser: the generated one, the hand-written one, or both with their
+// results compared
+typedef enum { PARSER_ANTLR, PARSER_HAND, PARSER_DIFF } ParserKind;
+
+struct ParseOptions {
+    ParserKind kind = PARSER_ANTLR;
+    // --profile-parser, prediction statistics of antlr's decisions
+    bool profile = false;
+};
+
+struct DriverOptions {
+    PATASK task = NO_TASK;
+    vector<string> files;
+    string manifest;
+    string outDir;
+    // worker threads of batch mode
+    int jobs = 1;
+    // socket to serve compile requests on
+    string server;
+    // -ftime-report
+    bool timeReport = false;
+    // reuse outputs of identical compilations kept here
+    string cacheDir;
+    // prediction DFA saved by earlier runs
+    string dfaCache;
+    ParseOptions parseOpts;
+    CodeGenOptions cgOpts;
+};
+
+// long-only options
+enum {
+    OPT_EMIT = 256,
+    OPT_THINLTO_SUMMARY,
+    OPT_LAZY_JIT,
+    OPT_MANIFEST,
+    OPT_SERVER,
+    OPT_CACHE_DIR,
+    OPT_DFA_CACHE,
+    OPT_PARSER,
+    OPT_PROFILE_PARSER
+};
+
+static const struct option longOpts[] = {
+    {"emit", required_argument, nullptr, OPT_EMIT},
+    {"thinlto-summary", no_argument, nullptr, OPT_THINLTO_SUMMARY},
+    {"lazy-jit", no_argument, nullptr, OPT_LAZY_JIT},
+    {"manifest", required_argument, nullptr, OPT_MANIFEST},
+    {"server", required_argument, nullptr, OPT_SERVER},
+    {"cache-dir", required_argument, nullptr, OPT_CACHE_DIR},
+    {"dfa-cache", required_argument, nullptr, OPT_DFA_CACHE},
+    {"parser", required_argument, nullptr, OPT_PARSER},
+    {"profile-parser", no_argument, nullptr, OPT_PROFILE_PARSER},
+    {nullptr, 0, nullptr, 0},
+};
+
+// Read input files from a manifest, one path per line
+static bool readManifest(const string &manifest, vector<string> &files) {
+    ifstream ifs(manifest);
+
+    if (!ifs.is_open()) {
+        cerr << "[error] fail to open " << manifest << " " << strerror(errno)
+             << endl;
+        return false;
+    }
+    for (string line; getline(ifs, line);) {
+        if (!line.empty()) {
+            files.push_back(line);
+        }
+    }
+    return true;
+}
+
+static int optHandle(int argc, char *const *argv, DriverOptions &dOpts) {
     int opt;
-    task = NO_TASK;
+    CodeGenOptions &cgOpts = dOpts.cgOpts;
     map<string, PATASK> paMap = {
         {"PA1", PA1_TASK},
         {"PA2", PA2_TASK},
         {"PA3", PA3_TASK},
+        {"RUN", RUN_TASK},
     };
     map<string, PATASK>::iterator iter;
+    map<string, EmitKind> emitMap = {
+        {"ll", EMIT_LL},
+        {"bc", EMIT_BC},
+        {"obj", EMIT_OBJ},
+        {"exe", EMIT_EXE},
+    };
+    map<string, EmitKind>::iterator emitIter;
+    map<string, ParserKind> parserMap = {
+        {"antlr", PARSER_ANTLR},
+        {"hand", PARSER_HAND},
+        {"diff", PARSER_DIFF},
+    };
+    map<string, ParserKind>::iterator parserIter;
 
-    while ((opt = getopt(argc, argv, "d:t:")) != -1) {
+    while ((opt = getopt_long(argc, argv, "d:t:O:j:f:", longOpts, nullptr)) !=
+           -1) {
         switch (opt) {
         case 'd':
+            dOpts.outDir = optarg;
+            break;
+        case OPT_EMIT:
+            emitIter = emitMap.find(optarg);
+            if (emitIter == emitMap.end()) {
+                cerr << "[error] invalid emit kind --emit=" << optarg << endl;
+                return -1;
+            }
+            cgOpts.emit = emitIter->second;
+            break;
+        case OPT_THINLTO_SUMMARY:
+            cgOpts.moduleSummary = true;
+            break;
+        case OPT_LAZY_JIT:
+            cgOpts.lazyJIT = true;
+            break;
+        case OPT_MANIFEST:
+            dOpts.manifest = optarg;
+            break;
+        case OPT_SERVER:
+            dOpts.server = optarg;
+            break;
+        case OPT_CACHE_DIR:
+            dOpts.cacheDir = optarg;
+            break;
+        case OPT_DFA_CACHE:
+            dOpts.dfaCache = optarg;
+            break;
+        case OPT_PARSER:
+            parserIter = parserMap.find(optarg);
+            if (parserIter == parserMap.end()) {
+                cerr << "[error] invalid parser --parser=" << optarg << endl;
+                return -1;
+            }
+            dOpts.parseOpts.kind = parserIter->second;
+            break;
+        case OPT_PROFILE_PARSER:
+            dOpts.parseOpts.profile = true;
             break;
         case 't':
             iter = paMap.find(optarg);
-            task = (iter != paMap.end()) ? iter->second : task;
+            dOpts.task = (iter != paMap.end()) ? iter->second : dOpts.task;
+            break;
+        case 'f':
+            // clang style -f<flag>
+            if (strcmp(optarg, "time-report") != 0) {
+                cerr << "[error] unknown option -f" << optarg << endl;
+                return -1;
+            }
+            dOpts.timeReport = true;
+            break;
+        case 'j':
+            dOpts.jobs = atoi(optarg);
+            if (dOpts.jobs < 1) {
+                cerr << "[error] invalid number of jobs -j" << optarg << endl;
+                return -1;
+            }
+            break;
+        case 'O':
+            if (strlen(optarg) != 1 || optarg[0] < '0' || optarg[0] > '3') {
+                cerr << "[error] invalid optimization level -O" << optarg
+                     << endl;
+                return -1;
+            }
+            cgOpts.optLevel = optarg[0] - '0';
             break;
         default:
             break;
         }
     }
-    if (optind == argc - 1) {
-        file = argv[optind];
+    for (int i = optind; i < argc; i++) {
+        dOpts.files.push_back(argv[i]);
+    }
+    if (!dOpts.manifest.empty() &&
+        !readManifest(dOpts.manifest, dOpts.files)) {
+        return -1;
     }
     return 0;
 }
 
-int main(int argc, char *argv[]) {
-    PATASK task;
-    string file;
+// <dir>/<stem><ext>
+static string getOutputPath(const string &outDir, const string &file,
+                            const string &ext) {
+    llvm::SmallString<128> out(outDir.empty() ? "." : outDir);
+    llvm::sys::path::append(out, file == "-" ? "stdin"
+                                             : llvm::sys::path::stem(file));
+    out += ext;
+    return out.str().str();
+}
 
-    optHandle(argc, argv, task, file);
+// Large sources are mapped rather than read, the lexer works on the mapping.
+// "-" is the standard input, which is read whole
+static unique_ptr<llvm::MemoryBuffer> readSource(const string &file) {
+    llvm::ErrorOr<unique_ptr<llvm::MemoryBuffer>> buf =
+        make_error_code(errc::bad_file_descriptor);
+    llvm::sys::fs::file_status status;
 
-    if (file.empty()) {
-        cerr << "[error] source file requested!" << endl;
-        return EXIT_FAILURE;
+    if (file == "-") {
+        buf = llvm::MemoryBuffer::getSTDIN();
+    } else if (auto fd = llvm::sys::fs::openNativeFileForRead(file)) {
+        error_code ec = llvm::sys::fs::status(*fd, status);
+        if (ec) {
+            buf = ec;
+        } else {
+            buf = llvm::MemoryBuffer::getOpenFile(*fd, file, status.getSize(),
+                                                  false);
+        }
+        llvm::sys::fs::closeFile(*fd);
+    } else {
+        buf = llvm::errorToErrorCode(fd.takeError());
     }
 
-    ifstream ifs(file);
+    if (!buf) {
+        getDiagnosticStream() << "[error] fail to open " << file << " "
+                              << buf.getError().message() << endl;
+        return nullptr;
+    }
+    return move(*buf);
+}
 
-    if (!ifs.is_open()) {
-        cerr << "[error] fail to open " << file << " " << strerror(errno) << endl;
-        return EXIT_FAILURE;
+// Parse with SLL prediction, bailing out at the first error, and only if
+// that fails parse again with full LL and the usual error recovery. SLL is
+// exact on the inputs it accepts, so valid programs get the same tree and
+// invalid ones the same errors, just the former much faster. Errors only go
+// to listener in the second parse. Without trySLL only the second parse is
+// done, for profiles: an SLL parse never falls back to full LL
+static tree::ParseTree *parseTopLevel(DecafParserParser &parser,
+                                      ANTLRErrorListener *listener,
+                                      bool trySLL) {
+    auto *interp = parser.getInterpreter<atn::ParserATNSimulator>();
+    auto errHandler = parser.getErrorHandler();
+
+    parser.removeErrorListeners();
+    if (trySLL) {
+        interp->setPredictionMode(atn::PredictionMode::SLL);
+        parser.setErrorHandler(make_shared<BailErrorStrategy>());
+        try {
+            tree::ParseTree *tree = parser.topLevel();
+            parser.setErrorHandler(errHandler);
+            parser.addErrorListener(listener);
+            return tree;
+        } catch (ParseCancellationException &) {
+        }
+        parser.reset();
     }
 
-    ANTLRInputStream input(ifs);
-    CommonLexer lexer(&input);
+    interp->setPredictionMode(atn::PredictionMode::LL);
+    parser.setErrorHandler(errHandler);
+    parser.addErrorListener(listener);
+    return parser.topLevel();
+}
+
+// Lex and parse source with antlr, then lower the parse tree into ast. The
+// lexer, tokens and parse tree are freed on return. With treeOut the parse
+// tree is printed there instead, and nothing is lowered. With profile the
+// decision profile of the parse is printed first, taken from a single full
+// LL parse so that its LL fallbacks show. False on lexical or syntax errors
+static bool parseANTLR(const llvm::MemoryBuffer &source, ostream *treeOut,
+                       ASTContext &ast, TimeReport *report, bool profile) {
+    Utf8CharStream input(source.getBufferStart(), source.getBufferSize(),
+                         source.getBufferIdentifier().str());
+    LiteralTable literals;
+    CommonLexer lexer(&input, literals);
+    lexer.removeErrorListeners();
+    lexer.addErrorListener(&DiagErrorListener::INSTANCE);
     CommonTokenStream tokens(&lexer);
-    tokens.fill();
-    ifs.close();
+
+    // Tokens are lexed as the parser's lookahead reaches them rather than
+    // all up front. Whatever the parser leaves is lexed afterwards so that
+    // its errors are still reported
+    DecafParserParser parser(&tokens);
+    if (profile) {
+        enableDecisionProfile(parser);
+    }
+    DeferredErrorListener parseErrors;
+    tree::ParseTree *tree;
+    {
+        TimeReport::Phase phase(report, "Lexing and parsing");
+        tree = parseTopLevel(parser, &parseErrors, !profile);
+        tokens.fill();
+    }
+    if (profile) {
+        printDecisionProfile(parser, getDiagnosticStream());
+    }
 
     if (lexer.lexerFailed) {
-        return EXIT_FAILURE;
+        return false;
     }
+    parseErrors.flush();
 
-    DecafParserParser parser(&tokens);
-    tree::ParseTree *tree = parser.topLevel();
+    if (treeOut) {
+        TimeReport::Phase phase(report, "AST printing");
+        ASTPrinter astPrinter(&parser, *treeOut);
+        astPrinter.visit(tree);
+        return true;
+    }
+
+    // A tree patched up by error recovery is not worth checking
+    if (parser.getNumberOfSyntaxErrors() > 0) {
+        return false;
+    }
+
+    TimeReport::Phase phase(report, "AST building");
+    ASTBuilder builder(ast, literals);
+    builder.build(static_cast<DecafParserParser::TopLevelContext *>(tree));
+    return true;
+}
+
+// Lex and parse source with the hand-written parser, straight into ast.
+// False on lexical or syntax errors, the latter only reported without the
+// former as with antlr
+static bool parseDescent(const llvm::MemoryBuffer &source, ASTContext &ast,
+                         TimeReport *report) {
+    Utf8CharStream input(source.getBufferStart(), source.getBufferSize(),
+                         source.getBufferIdentifier().str());
+    LiteralTable literals;
+    CommonLexer lexer(&input, literals);
+    lexer.removeErrorListeners();
+    lexer.addErrorListener(&DiagErrorListener::INSTANCE);
+
+    DescentParser parser(lexer, literals, ast);
+    TopLevel *root;
+    {
+        TimeReport::Phase phase(report, "Lexing and parsing");
+        root = parser.parse();
+    }
+
+    if (lexer.lexerFailed) {
+        return false;
+    }
+    if (!root) {
+        getDiagnosticStream() << parser.getError();
+        return false;
+    }
+    return true;
+}
+
+// Run both parsers on source and report where the hand-written one differs
+// from antlr: accepting a different set of programs, or building another
+// tree. Their own messages are dropped
+static bool compareParsers(const llvm::MemoryBuffer &source) {
+    ostream &diag = getDiagnosticStream();
+    ostringstream discarded;
+    ASTContext antlrAst, handAst;
+
+    setDiagnosticStream(&discarded);
+    bool antlrOk = parseANTLR(source, nullptr, antlrAst, nullptr, false);
+    bool handOk = parseDescent(source, handAst, nullptr);
+    setDiagnosticStream(&diag);
+
+    if (antlrOk != handOk) {
+        diag << "[error] the hand-written parser "
+             << (handOk ? "accepts" : "rejects") << " a program antlr "
+             << (antlrOk ? "accepts" : "rejects") << endl;
+        return false;
+    }
+    if (!antlrOk) {
+        return true;
+    }
+    if (const ASTNode *node = findMismatch(handAst.root, antlrAst.root)) {
+        diag << "[error] the hand-written parser disagrees with antlr at "
+             << node->pos.toString() << endl;
+        return false;
+    }
+    return true;
+}
+
+// Parse source into cc's AST with the chosen parser. For PA1 antlr's parse
+// tree is printed to out instead, whatever the parser. Only antlr is
+// profiled
+static bool parseProgram(const llvm::MemoryBuffer &source, PATASK task,
+                         const ParseOptions &parseOpts, CompileContext &cc,
+                         TimeReport *report, ostream &out) {
+    if (parseOpts.kind == PARSER_DIFF && !compareParsers(source)) {
+        return false;
+    }
+    if (task == PA1_TASK || parseOpts.kind != PARSER_HAND) {
+        return parseANTLR(source, task == PA1_TASK ? &out : nullptr, cc.ast,
+                          report, parseOpts.profile);
+    }
+    return parseDescent(source, cc.ast, report);
+}
+
+static bool compileProgram(const llvm::MemoryBuffer &source, PATASK task,
+                           const ParseOptions &parseOpts,
+                           CodeGenOptions cgOpts, ostream &out) {
+    TimeReport *report = cgOpts.timeReport;
 
+    CompileContext cc;
+    if (!parseProgram(source, task, parseOpts, cc, report, out)) {
+        return false;
+    }
     if (task == PA1_TASK) {
-        ASTPrinter astPrinter(&parser);
-        astPrinter.visit(tree);
-        return EXIT_SUCCESS;
+        return true;
     }
+    TopLevel *ast = cc.ast.root;
 
     // Build Symbol Table
-    SymbolChecker symChker(tree);
-    std::shared_ptr<Scope> globalScope = symChker.buildTable();
-    if (globalScope == nullptr) {
-        return EXIT_FAILURE;
+    {
+        TimeReport::Phase phase(report, "Symbol table");
+        SymbolChecker symChker(ast, cc);
+        cc.globalScope = symChker.buildTable();
+    }
+    if (cc.globalScope == nullptr) {
+        return false;
     }
 
     // Type-checking
-    std::shared_ptr<ASTAttrManager> attrManager =
-        std::make_shared<ASTAttrManager>();
-    TypeChecker typeChker(tree, globalScope, attrManager);
-    if (!typeChker.check()) {
-        return EXIT_FAILURE;
+    bool typeOk;
+    {
+        TimeReport::Phase phase(report, "Type checking");
+        TypeChecker typeChker(ast, cc);
+        typeOk = typeChker.check();
+    }
+    if (!typeOk) {
+        return false;
     }
     if (task == PA2_TASK) {
-        globalScope->print(0);
-        return EXIT_SUCCESS;
+        TimeReport::Phase phase(report, "Scope printing");
+        cc.globalScope->print(out, 0);
+        return true;
     }
 
     // Code Generation
-    CodeGenVisitor cgen(tree, globalScope, attrManager);
-    cgen.codegen();
+    if (task == RUN_TASK) {
+        cgOpts.emit = EMIT_JIT;
+    }
+    CodeGenVisitor cgen(ast, cc, cgOpts);
+    return cgen.codegen();
+}
+
+// Everything besides the source that determines the cached output
+static string getCacheConfig(PATASK task, const CodeGenOptions &cgOpts) {
+    return string("task=")
+        .append(to_string(task))
+        .append(";emit=")
+        .append(to_string(cgOpts.emit))
+        .append(";O=")
+        .append(to_string(cgOpts.optLevel))
+        .append(";summary=")
+        .append(to_string(cgOpts.moduleSummary))
+        .append(";triple=")
+        .append(llvm::sys::getDefaultTargetTriple());
+}
+
+// Reuse the output of an identical earlier compilation, or compile and add
+// the output to the cache
+static bool compileCached(const string &cacheDir,
+                          const llvm::MemoryBuffer &source,
+                          PATASK task, const ParseOptions &parseOpts,
+                          CodeGenOptions cgOpts, ostream &out) {
+    CompileCache cache(cacheDir);
+    string key;
+    {
+        TimeReport::Phase phase(cgOpts.timeReport, "Cache lookup");
+        key = CompileCache::getKey(getCacheConfig(task, cgOpts),
+                                   source.getBuffer());
+        if (cache.fetch(key, cgOpts.output, out)) {
+            return true;
+        }
+    }
+
+    // Output meant for stdout is produced in the cache directory first.
+    // Bitcode isn't, so that it is still refused on a terminal
+    bool toStdout = cgOpts.output.empty();
+    if (toStdout && (cgOpts.emit == EMIT_BC && isatty(STDOUT_FILENO))) {
+        return compileProgram(source, task, parseOpts, cgOpts, out);
+    }
+    if (toStdout) {
+        cgOpts.output = cache.getTempPath(key);
+        if (cgOpts.output.empty()) {
+            return false;
+        }
+    }
+
+    bool ok = compileProgram(source, task, parseOpts, cgOpts, out);
+    // A failed store only costs the next compilation a miss
+    if (ok) {
+        cache.store(key, cgOpts.output);
+    }
+    if (toStdout) {
+        if (ok) {
+            out << ifstream(cgOpts.output, ios::binary).rdbuf() << flush;
+        }
+        llvm::sys::fs::remove(cgOpts.output);
+    }
+    return ok;
+}
+
+// Compile one program. Dumps of PA1/PA2 go to out, errors and the time
+// report go to the diagnostic stream of the calling thread
+static bool compileFile(const DriverOptions &dOpts, const string &file,
+                        CodeGenOptions cgOpts, ostream &out) {
+    unique_ptr<llvm::MemoryBuffer> source = readSource(file);
+    if (!source) {
+        return false;
+    }
+
+    TimeReport report;
+    if (dOpts.timeReport) {
+        cgOpts.timeReport = &report;
+    }
+
+    // Only code generation produces something worth caching. Comparing or
+    // profiling the parsers has to parse every time
+    bool ok;
+    const ParseOptions &parseOpts = dOpts.parseOpts;
+    bool cacheable = (dOpts.task == NO_TASK || dOpts.task == PA3_TASK) &&
+                     parseOpts.kind != PARSER_DIFF && !parseOpts.profile;
+    if (!dOpts.cacheDir.empty() && cacheable) {
+        ok = compileCached(dOpts.cacheDir, *source, dOpts.task, parseOpts,
+                           cgOpts, out);
+    } else {
+        ok = compileProgram(*source, dOpts.task, parseOpts, cgOpts, out);
+    }
 
-    return EXIT_SUCCESS;
+    if (dOpts.timeReport) {
+        report.print(getDiagnosticStream());
+    }
+    return ok;
 }
+
+// Compile every input in this process on dOpts.jobs threads. Each one writes
+// its own outputs into the output directory and its messages into
+// <dir>/<stem>.output, so inputs sharing a stem are refused up front
+static bool compileBatch(const DriverOptions &dOpts) {
+    const map<EmitKind, string> exts = {
+        {EMIT_LL, ".ll"},
+        {EMIT_BC, ".bc"},
+        {EMIT_OBJ, ".o"},
+        {EMIT_EXE, ""},
+    };
+    const vector<string> &files = dOpts.files;
+    map<string, string> logFiles;
+    for (const string &file : files) {
+        string logFile = getOutputPath(dOpts.outDir, file, ".output");
+        auto res = logFiles.emplace(logFile, file);
+        if (!res.second) {
+            cerr << "[error] " << res.first->second << " and " << file
+                 << " would write the same outputs" << endl;
+            return false;
+        }
+    }
+
+    atomic<size_t> next(0);
+    atomic<bool> ok(true);
+
+    auto worker = [&]() {
+        for (size_t i = next++; i < files.size(); i = next++) {
+            const string &file = files[i];
+            CodeGenOptions opts = dOpts.cgOpts;
+            opts.output =
+                getOutputPath(dOpts.outDir, file, exts.at(opts.emit));
+
+            string logFile = getOutputPath(dOpts.outDir, file, ".output");
+            ofstream log(logFile);
+            if (!log.is_open()) {
+                cerr << "[error] fail to open " + logFile + " " +
+                            strerror(errno) + "\n";
+                ok = false;
+                continue;
+            }
+
+            setDiagnosticStream(&log);
+            bool compiled = compileFile(dOpts, file, opts, log);
+            setDiagnosticStream(&cerr);
+            if (!compiled) {
+                cerr << "[error] fail to compile " + file + "\n";
+                ok = false;
+            }
+        }
+    };
+
+    // Programs run by the JIT share the process's stdout. LLVM's pass timers
+    // and the RSS of -ftime-report are process-wide, so it needs the process
+    // to itself as well
+    int jobs = dOpts.task == RUN_TASK ? 1 : dOpts.jobs;
+    if (dOpts.timeReport && jobs > 1) {
+        cerr << "[warning] -ftime-report compiles one file at a time, "
+                "ignoring -j"
+             << endl;
+        jobs = 1;
+    }
+    vector<thread> threads;
+    for (int i = 1; i < jobs; i++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto &t : threads) {
+        t.join();
+    }
+    return ok;
+}
+
+// Warm up the parser with the DFA of earlier runs: the one given by
+// --dfa-cache, or the one installed next to the binary. Server requests
+// start with the DFA their server loaded
+static void loadDFACache(const DriverOptions &dOpts) {
+    static bool loaded = false;
+    if (loaded) {
+        return;
+    }
+    loaded = true;
+
+    string path = dOpts.dfaCache;
+    if (path.empty()) {
+        path = DFACache::getDefaultPath();
+        if (!llvm::sys::fs::exists(path)) {
+            return;
+        }
+    }
+    if (!DFACache::load(path) && !dOpts.dfaCache.empty()) {
+        cerr << "[warning] ignore DFA cache " << path << endl;
+    }
+}
+
+// Only --dfa-cache is written back, the installed cache stays as is
+static void saveDFACache(const DriverOptions &dOpts) {
+    if (!dOpts.dfaCache.empty() && !DFACache::save(dOpts.dfaCache)) {
+        cerr << "[error] fail to write " << dOpts.dfaCache << endl;
+    }
+}
+
+static int runDriver(int argc, char *argv[]) {
+    DriverOptions dOpts;
+
+    if (optHandle(argc, argv, dOpts) != 0) {
+        return EXIT_FAILURE;
+    }
+    loadDFACache(dOpts);
+
+    // Initialize once, every request is then served by a fork of this process
+    if (!dOpts.server.empty()) {
+        CodeGenVisitor::initLLVM();
+        return runServer(dOpts.server, runDriver);
+    }
+
+    if (dOpts.files.empty()) {
+        cerr << "[error] source file requested!" << endl;
+        return EXIT_FAILURE;
+    }
+
+    if (dOpts.files.size() > 1 || !dOpts.manifest.empty()) {
+        bool ok = compileBatch(dOpts);
+        saveDFACache(dOpts);
+        return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // Objects and executables are always written to <dir>, bitcode only if
+    // -d is given
+    const string &file = dOpts.files[0];
+    const string &outDir = dOpts.outDir;
+    CodeGenOptions &cgOpts = dOpts.cgOpts;
+    if (cgOpts.emit == EMIT_OBJ) {
+        cgOpts.output = getOutputPath(outDir, file, ".o");
+    } else if (cgOpts.emit == EMIT_EXE) {
+        cgOpts.output = getOutputPath(outDir, file, "");
+    } else if (cgOpts.emit == EMIT_BC && !outDir.empty()) {
+        cgOpts.output = getOutputPath(outDir, file, ".bc");
+    }
+
+    bool ok = compileFile(dOpts, file, cgOpts, cout);
+    saveDFACache(dOpts);
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int main(int argc, char *argv[]) { return runDriver(argc, argv); }
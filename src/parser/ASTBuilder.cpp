@@ -0,0 +1,405 @@
+#include "ASTBuilder.h"
+#include "Pos.h"
+
+ASTBuilder::ASTBuilder(ASTContext &ast, const LiteralTable &literals)
+    : ast(ast), literals(literals) {}
+
+TopLevel *ASTBuilder::build(DecafParserParser::TopLevelContext *ctx) {
+    std::vector<ClassDef *> classes;
+    for (auto *c : ctx->classDef()) {
+        classes.push_back(buildClassDef(c));
+    }
+    ast.root = ast.create<TopLevel>(getTokenPos(ctx->getStart()),
+                                    ast.copyArray(classes));
+    return ast.root;
+}
+
+ClassDef *ASTBuilder::buildClassDef(DecafParserParser::ClassDefContext *ctx) {
+    Name baseName;
+    if (ctx->extendClause()) {
+        baseName = getName(ctx->extendClause()->id());
+    }
+
+    std::vector<ASTNode *> fields;
+    for (auto *f : ctx->field()) {
+        if (f->varDef()) {
+            fields.push_back(buildVar(f->varDef()->var()));
+        } else {
+            fields.push_back(buildMethodDef(f->methodDef()));
+        }
+    }
+    return ast.create<ClassDef>(getTokenPos(ctx->CLASS()->getSymbol()),
+                                getName(ctx->id()), baseName,
+                                ast.copyArray(fields));
+}
+
+MethodDef *
+ASTBuilder::buildMethodDef(DecafParserParser::MethodDefContext *ctx) {
+    std::vector<VarDef *> params;
+    for (auto *p : ctx->varList()->paraVarDef()) {
+        params.push_back(buildVar(p->var()));
+    }
+    return ast.create<MethodDef>(getTokenPos(ctx->id()->getStart()),
+                                 ctx->STATIC() != nullptr,
+                                 buildType(ctx->type()), getName(ctx->id()),
+                                 ast.copyArray(params),
+                                 buildBlock(ctx->block()));
+}
+
+VarDef *ASTBuilder::buildVar(DecafParserParser::VarContext *ctx) {
+    return ast.create<VarDef>(getTokenPos(ctx->id()->getStart()),
+                              buildType(ctx->type()), getName(ctx->id()));
+}
+
+TypeLit *ASTBuilder::buildType(DecafParserParser::TypeContext *ctx) {
+    Pos pos = getTokenPos(ctx->getStart());
+
+    if (ctx->INT()) {
+        return ast.create<TypeLit>(pos, TypeLit::INT);
+    } else if (ctx->BOOL()) {
+        return ast.create<TypeLit>(pos, TypeLit::BOOL);
+    } else if (ctx->STRING()) {
+        return ast.create<TypeLit>(pos, TypeLit::STRING);
+    } else if (ctx->VOID()) {
+        return ast.create<TypeLit>(pos, TypeLit::VOID);
+    } else if (ctx->classType()) {
+        TypeLit *t = ast.create<TypeLit>(pos, TypeLit::CLASS);
+        t->className = getName(ctx->classType()->id());
+        return t;
+    }
+    TypeLit *t = ast.create<TypeLit>(pos, TypeLit::ARRAY);
+    t->elem = buildType(ctx->type());
+    return t;
+}
+
+Block *ASTBuilder::buildBlock(DecafParserParser::BlockContext *ctx) {
+    std::vector<Stmt *> stmts;
+    for (auto *s : ctx->blockStmt()) {
+        if (s->localVarDefStmt()) {
+            stmts.push_back(
+                buildLocalVarDef(s->localVarDefStmt()->localVarDef()));
+        } else {
+            stmts.push_back(buildStmt(s->stmt()));
+        }
+    }
+    return ast.create<Block>(getTokenPos(ctx->LBRACE()->getSymbol()),
+                             ast.copyArray(stmts));
+}
+
+Stmt *ASTBuilder::buildStmt(DecafParserParser::StmtContext *ctx) {
+    if (ctx->block()) {
+        return buildBlock(ctx->block());
+    } else if (auto *s = ctx->emptyStmt()) {
+        return ast.create<EmptyStmt>(getTokenPos(s->SEMI()->getSymbol()));
+    } else if (auto *s = ctx->exprStmt()) {
+        return ast.create<ExprStmt>(buildExpr(s->expr()));
+    } else if (auto *s = ctx->assignStmt()) {
+        return buildAssign(s->assign());
+    } else if (auto *s = ctx->ifStmt()) {
+        Stmt *elseStmt = s->ELSE() ? buildStmt(s->stmt(1)) : nullptr;
+        return ast.create<IfStmt>(getTokenPos(s->IF()->getSymbol()),
+                                  buildExpr(s->expr()), buildStmt(s->stmt(0)),
+                                  elseStmt);
+    } else if (auto *s = ctx->whileStmt()) {
+        return ast.create<WhileStmt>(getTokenPos(s->WHILE()->getSymbol()),
+                                     buildExpr(s->expr()),
+                                     buildStmt(s->stmt()));
+    } else if (ctx->forStmt()) {
+        return buildFor(ctx->forStmt());
+    } else if (auto *s = ctx->breakStmt()) {
+        return ast.create<BreakStmt>(getTokenPos(s->BREAK()->getSymbol()));
+    } else if (auto *s = ctx->returnStmt()) {
+        Expr *expr = s->expr() ? buildExpr(s->expr()) : nullptr;
+        return ast.create<ReturnStmt>(getTokenPos(s->RETURN()->getSymbol()),
+                                      expr);
+    }
+    auto *s = ctx->printStmt();
+    return ast.create<PrintStmt>(getTokenPos(s->PRINT()->getSymbol()),
+                                 ast.copyArray(buildExprList(s->exprList())));
+}
+
+LocalVarDef *
+ASTBuilder::buildLocalVarDef(DecafParserParser::LocalVarDefContext *ctx) {
+    Expr *init = nullptr;
+    Pos opPos;
+    if (ctx->bop) {
+        init = buildExpr(ctx->expr());
+        opPos = getTokenPos(ctx->bop);
+    }
+    return ast.create<LocalVarDef>(buildVar(ctx->var()), init, opPos);
+}
+
+Assign *ASTBuilder::buildAssign(DecafParserParser::AssignContext *ctx) {
+    return ast.create<Assign>(buildLValue(ctx->lValue()),
+                              buildExpr(ctx->expr()), getTokenPos(ctx->bop));
+}
+
+Stmt *ASTBuilder::buildFor(DecafParserParser::ForStmtContext *ctx) {
+    DecafParserParser::ForControlContext *control = ctx->forControl();
+
+    Stmt *init = nullptr;
+    if (auto *i = control->forInit()) {
+        if (i->localVarDef()) {
+            init = buildLocalVarDef(i->localVarDef());
+        } else {
+            init = buildAssign(i->assign());
+        }
+    }
+
+    Stmt *update = nullptr;
+    if (auto *u = control->forUpdate()) {
+        if (u->assign()) {
+            update = buildAssign(u->assign());
+        } else {
+            update = ast.create<ExprStmt>(buildExpr(u->expr()));
+        }
+    }
+
+    return ast.create<ForStmt>(getTokenPos(ctx->FOR()->getSymbol()), init,
+                               buildExpr(control->expr()), update,
+                               buildStmt(ctx->stmt()));
+}
+
+Expr *ASTBuilder::buildExpr(DecafParserParser::ExprContext *ctx) {
+    return visit(ctx).as<Expr *>();
+}
+
+Expr *ASTBuilder::buildLValue(DecafParserParser::LValueContext *ctx) {
+    if (auto *l = dynamic_cast<DecafParserParser::VarSelLValueContext *>(ctx)) {
+        Pos namePos = getTokenPos(l->id()->getStart());
+        Expr *receiver = l->expr() ? buildExpr(l->expr()) : nullptr;
+        Pos pos = receiver ? receiver->pos : namePos;
+        return ast.create<VarSel>(pos, receiver, getName(l->id()), namePos);
+    }
+    auto *l = static_cast<DecafParserParser::IndexSelLValueContext *>(ctx);
+    return ast.create<IndexSel>(buildExpr(l->expr(0)), buildExpr(l->expr(1)),
+                                getTokenPos(l->LBRACKET()->getSymbol()));
+}
+
+Expr *ASTBuilder::buildBinary(DecafParserParser::ExprContext *lhs,
+                              DecafParserParser::ExprContext *rhs,
+                              antlr4::Token *bop) {
+    Binary::Op op = Binary::MUL;
+    switch (bop->getType()) {
+    case DecafParserParser::MUL:
+        op = Binary::MUL;
+        break;
+    case DecafParserParser::DIV:
+        op = Binary::DIV;
+        break;
+    case DecafParserParser::MOD:
+        op = Binary::MOD;
+        break;
+    case DecafParserParser::ADD:
+        op = Binary::ADD;
+        break;
+    case DecafParserParser::SUB:
+        op = Binary::SUB;
+        break;
+    case DecafParserParser::LE:
+        op = Binary::LE;
+        break;
+    case DecafParserParser::LT:
+        op = Binary::LT;
+        break;
+    case DecafParserParser::GE:
+        op = Binary::GE;
+        break;
+    case DecafParserParser::GT:
+        op = Binary::GT;
+        break;
+    case DecafParserParser::EQ:
+        op = Binary::EQ;
+        break;
+    case DecafParserParser::NE:
+        op = Binary::NE;
+        break;
+    case DecafParserParser::AND:
+        op = Binary::AND;
+        break;
+    case DecafParserParser::OR:
+        op = Binary::OR;
+        break;
+    }
+    Expr *l = buildExpr(lhs);
+    Expr *r = buildExpr(rhs);
+    return ast.create<Binary>(op, l, r, getTokenPos(bop));
+}
+
+std::vector<Expr *>
+ASTBuilder::buildExprList(DecafParserParser::ExprListContext *ctx) {
+    std::vector<Expr *> exprs;
+    for (auto *e : ctx->expr()) {
+        exprs.push_back(buildExpr(e));
+    }
+    return exprs;
+}
+
+Name ASTBuilder::getName(DecafParserParser::IdContext *ctx) {
+    return ast.intern(ctx->IDENTIFIER()->getSymbol()->getText());
+}
+
+antlrcpp::Any
+ASTBuilder::visitLitExpr(DecafParserParser::LitExprContext *ctx) {
+    return visit(ctx->lit());
+}
+
+antlrcpp::Any
+ASTBuilder::visitThisExpr(DecafParserParser::ThisExprContext *ctx) {
+    return static_cast<Expr *>(
+        ast.create<ThisExpr>(getTokenPos(ctx->THIS()->getSymbol())));
+}
+
+antlrcpp::Any ASTBuilder::visitIdExpr(DecafParserParser::IdExprContext *ctx) {
+    Pos pos = getTokenPos(ctx->id()->getStart());
+    return static_cast<Expr *>(
+        ast.create<VarSel>(pos, nullptr, getName(ctx->id()), pos));
+}
+
+antlrcpp::Any
+ASTBuilder::visitParenExpr(DecafParserParser::ParenExprContext *ctx) {
+    return static_cast<Expr *>(ast.create<Paren>(
+        getTokenPos(ctx->LPAREN()->getSymbol()), buildExpr(ctx->expr())));
+}
+
+antlrcpp::Any
+ASTBuilder::visitVarSelExpr(DecafParserParser::VarSelExprContext *ctx) {
+    Expr *receiver = buildExpr(ctx->expr());
+    return static_cast<Expr *>(
+        ast.create<VarSel>(receiver->pos, receiver, getName(ctx->id()),
+                           getTokenPos(ctx->id()->getStart())));
+}
+
+antlrcpp::Any
+ASTBuilder::visitIndexSelExpr(DecafParserParser::IndexSelExprContext *ctx) {
+    Expr *array = buildExpr(ctx->expr(0));
+    Expr *index = buildExpr(ctx->expr(1));
+    return static_cast<Expr *>(ast.create<IndexSel>(
+        array, index, getTokenPos(ctx->LBRACKET()->getSymbol())));
+}
+
+antlrcpp::Any
+ASTBuilder::visitVarCallExpr(DecafParserParser::VarCallExprContext *ctx) {
+    Expr *receiver = buildExpr(ctx->expr());
+    std::vector<Expr *> args = buildExprList(ctx->exprList());
+    return static_cast<Expr *>(ast.create<Call>(
+        receiver->pos, receiver, getName(ctx->id()),
+        getTokenPos(ctx->id()->getStart()),
+        getTokenPos(ctx->LPAREN()->getSymbol()), ast.copyArray(args)));
+}
+
+antlrcpp::Any
+ASTBuilder::visitLocalCallExpr(DecafParserParser::LocalCallExprContext *ctx) {
+    Pos pos = getTokenPos(ctx->id()->getStart());
+    std::vector<Expr *> args = buildExprList(ctx->exprList());
+    return static_cast<Expr *>(ast.create<Call>(
+        pos, nullptr, getName(ctx->id()), pos,
+        getTokenPos(ctx->LPAREN()->getSymbol()), ast.copyArray(args)));
+}
+
+antlrcpp::Any
+ASTBuilder::visitUnaryNotExpr(DecafParserParser::UnaryNotExprContext *ctx) {
+    return static_cast<Expr *>(ast.create<Unary>(
+        getTokenPos(ctx->uop), Unary::NOT, buildExpr(ctx->expr())));
+}
+
+antlrcpp::Any
+ASTBuilder::visitUnarySubExpr(DecafParserParser::UnarySubExprContext *ctx) {
+    return static_cast<Expr *>(ast.create<Unary>(
+        getTokenPos(ctx->uop), Unary::NEG, buildExpr(ctx->expr())));
+}
+
+antlrcpp::Any ASTBuilder::visitCastExpr(DecafParserParser::CastExprContext *ctx) {
+    return static_cast<Expr *>(ast.create<Cast>(
+        getTokenPos(ctx->LPAREN()->getSymbol()), getName(ctx->id()),
+        getTokenPos(ctx->id()->getStart()), buildExpr(ctx->expr())));
+}
+
+antlrcpp::Any ASTBuilder::visitMultiplicativeExpr(
+    DecafParserParser::MultiplicativeExprContext *ctx) {
+    return buildBinary(ctx->expr(0), ctx->expr(1), ctx->bop);
+}
+
+antlrcpp::Any
+ASTBuilder::visitAddictiveExpr(DecafParserParser::AddictiveExprContext *ctx) {
+    return buildBinary(ctx->expr(0), ctx->expr(1), ctx->bop);
+}
+
+antlrcpp::Any
+ASTBuilder::visitRelationExpr(DecafParserParser::RelationExprContext *ctx) {
+    return buildBinary(ctx->expr(0), ctx->expr(1), ctx->bop);
+}
+
+antlrcpp::Any
+ASTBuilder::visitEqualityExpr(DecafParserParser::EqualityExprContext *ctx) {
+    return buildBinary(ctx->expr(0), ctx->expr(1), ctx->bop);
+}
+
+antlrcpp::Any ASTBuilder::visitLogicalAndExpr(
+    DecafParserParser::LogicalAndExprContext *ctx) {
+    return buildBinary(ctx->expr(0), ctx->expr(1), ctx->bop);
+}
+
+antlrcpp::Any
+ASTBuilder::visitLogicalOrExpr(DecafParserParser::LogicalOrExprContext *ctx) {
+    return buildBinary(ctx->expr(0), ctx->expr(1), ctx->bop);
+}
+
+antlrcpp::Any
+ASTBuilder::visitReadIntExpr(DecafParserParser::ReadIntExprContext *ctx) {
+    return static_cast<Expr *>(
+        ast.create<ReadInt>(getTokenPos(ctx->READINTEGER()->getSymbol())));
+}
+
+antlrcpp::Any
+ASTBuilder::visitReadLineExpr(DecafParserParser::ReadLineExprContext *ctx) {
+    return static_cast<Expr *>(
+        ast.create<ReadLine>(getTokenPos(ctx->READLINE()->getSymbol())));
+}
+
+antlrcpp::Any
+ASTBuilder::visitClassNewExpr(DecafParserParser::ClassNewExprContext *ctx) {
+    return static_cast<Expr *>(ast.create<ClassNew>(
+        getTokenPos(ctx->NEW()->getSymbol()), getName(ctx->id())));
+}
+
+antlrcpp::Any
+ASTBuilder::visitArrayNewExpr(DecafParserParser::ArrayNewExprContext *ctx) {
+    TypeLit *elemType = buildType(ctx->type());
+    return static_cast<Expr *>(
+        ast.create<ArrayNew>(getTokenPos(ctx->NEW()->getSymbol()), elemType,
+                             buildExpr(ctx->expr())));
+}
+
+antlrcpp::Any ASTBuilder::visitInstanceofExpr(
+    DecafParserParser::InstanceofExprContext *ctx) {
+    Expr *expr = buildExpr(ctx->expr());
+    return static_cast<Expr *>(ast.create<Instanceof>(
+        getTokenPos(ctx->INSTANCEOF()->getSymbol()), expr, getName(ctx->id()),
+        getTokenPos(ctx->id()->getStart())));
+}
+
+antlrcpp::Any ASTBuilder::visitIntLit(DecafParserParser::IntLitContext *ctx) {
+    antlr4::Token *tok = ctx->INTLIT()->getSymbol();
+    return static_cast<Expr *>(
+        ast.create<IntLit>(getTokenPos(tok), literals.getIntValue(tok)));
+}
+
+antlrcpp::Any
+ASTBuilder::visitBoolLit(DecafParserParser::BoolLitContext *ctx) {
+    return static_cast<Expr *>(ast.create<BoolLit>(
+        getTokenPos(ctx->getStart()), ctx->TRUE() != nullptr));
+}
+
+antlrcpp::Any
+ASTBuilder::visitNullLit(DecafParserParser::NullLitContext *ctx) {
+    return static_cast<Expr *>(
+        ast.create<NullLit>(getTokenPos(ctx->NULLLIT()->getSymbol())));
+}
+
+antlrcpp::Any
+ASTBuilder::visitStringLit(DecafParserParser::StringLitContext *ctx) {
+    antlr4::Token *tok = ctx->STRING_LIT()->getSymbol();
+    return static_cast<Expr *>(ast.create<StringLit>(
+        getTokenPos(tok), ast.save(literals.getStringValue(tok))));
+}
@@ -0,0 +1,123 @@
+#ifndef _AST_BUILDER_H_
+#define _AST_BUILDER_H_
+
+#include "DecafParserBaseVisitor.h"
+#include "DecafParserParser.h"
+#include "antlr4-runtime.h"
+#include "ast/AST.h"
+#include "utils/LiteralTable.h"
+
+// Lowers a parse tree into the AST of an ASTContext. The parse tree, and the
+// tokens and literal table it came with, may be freed afterwards: the AST
+// keeps copies of the names, literal values and positions it needs.
+// Expressions are lowered by the visit methods, each returning an Expr *
+class ASTBuilder : public DecafParserBaseVisitor {
+public:
+    ASTBuilder(ASTContext &ast, const LiteralTable &literals);
+
+    TopLevel *build(DecafParserParser::TopLevelContext *ctx);
+
+    virtual antlrcpp::Any
+    visitLitExpr(DecafParserParser::LitExprContext *ctx) override;
+
+    virtual antlrcpp::Any
+    visitThisExpr(DecafParserParser::ThisExprContext *ctx) override;
+
+    virtual antlrcpp::Any
+    visitIdExpr(DecafParserParser::IdExprContext *ctx) override;
+
+    virtual antlrcpp::Any
+    visitParenExpr(DecafParserParser::ParenExprContext *ctx) override;
+
+    virtual antlrcpp::Any
+    visitVarSelExpr(DecafParserParser::VarSelExprContext *ctx) override;
+
+    virtual antlrcpp::Any
+    visitIndexSelExpr(DecafParserParser::IndexSelExprContext *ctx) override;
+
+    virtual antlrcpp::Any
+    visitVarCallExpr(DecafParserParser::VarCallExprContext *ctx) override;
+
+    virtual antlrcpp::Any
+    visitLocalCallExpr(DecafParserParser::LocalCallExprContext *ctx) override;
+
+    virtual antlrcpp::Any
+    visitUnaryNotExpr(DecafParserParser::UnaryNotExprContext *ctx) override;
+
+    virtual antlrcpp::Any
+    visitUnarySubExpr(DecafParserParser::UnarySubExprContext *ctx) override;
+
+    virtual antlrcpp::Any
+    visitCastExpr(DecafParserParser::CastExprContext *ctx) override;
+
+    virtual antlrcpp::Any visitMultiplicativeExpr(
+        DecafParserParser::MultiplicativeExprContext *ctx) override;
+
+    virtual antlrcpp::Any
+    visitAddictiveExpr(DecafParserParser::AddictiveExprContext *ctx) override;
+
+    virtual antlrcpp::Any
+    visitRelationExpr(DecafParserParser::RelationExprContext *ctx) override;
+
+    virtual antlrcpp::Any
+    visitEqualityExpr(DecafParserParser::EqualityExprContext *ctx) override;
+
+    virtual antlrcpp::Any
+    visitLogicalAndExpr(DecafParserParser::LogicalAndExprContext *ctx) override;
+
+    virtual antlrcpp::Any
+    visitLogicalOrExpr(DecafParserParser::LogicalOrExprContext *ctx) override;
+
+    virtual antlrcpp::Any
+    visitReadIntExpr(DecafParserParser::ReadIntExprContext *ctx) override;
+
+    virtual antlrcpp::Any
+    visitReadLineExpr(DecafParserParser::ReadLineExprContext *ctx) override;
+
+    virtual antlrcpp::Any
+    visitClassNewExpr(DecafParserParser::ClassNewExprContext *ctx) override;
+
+    virtual antlrcpp::Any
+    visitArrayNewExpr(DecafParserParser::ArrayNewExprContext *ctx) override;
+
+    virtual antlrcpp::Any
+    visitInstanceofExpr(DecafParserParser::InstanceofExprContext *ctx) override;
+
+    virtual antlrcpp::Any
+    visitIntLit(DecafParserParser::IntLitContext *ctx) override;
+
+    virtual antlrcpp::Any
+    visitBoolLit(DecafParserParser::BoolLitContext *ctx) override;
+
+    virtual antlrcpp::Any
+    visitNullLit(DecafParserParser::NullLitContext *ctx) override;
+
+    virtual antlrcpp::Any
+    visitStringLit(DecafParserParser::StringLitContext *ctx) override;
+
+private:
+    ASTContext &ast;
+    const LiteralTable &literals;
+
+    ClassDef *buildClassDef(DecafParserParser::ClassDefContext *ctx);
+    MethodDef *buildMethodDef(DecafParserParser::MethodDefContext *ctx);
+    VarDef *buildVar(DecafParserParser::VarContext *ctx);
+    TypeLit *buildType(DecafParserParser::TypeContext *ctx);
+
+    Block *buildBlock(DecafParserParser::BlockContext *ctx);
+    Stmt *buildStmt(DecafParserParser::StmtContext *ctx);
+    LocalVarDef *buildLocalVarDef(DecafParserParser::LocalVarDefContext *ctx);
+    Assign *buildAssign(DecafParserParser::AssignContext *ctx);
+    Stmt *buildFor(DecafParserParser::ForStmtContext *ctx);
+
+    Expr *buildExpr(DecafParserParser::ExprContext *ctx);
+    Expr *buildLValue(DecafParserParser::LValueContext *ctx);
+    Expr *buildBinary(DecafParserParser::ExprContext *lhs,
+                      DecafParserParser::ExprContext *rhs,
+                      antlr4::Token *bop);
+    std::vector<Expr *> buildExprList(DecafParserParser::ExprListContext *ctx);
+
+    Name getName(DecafParserParser::IdContext *ctx);
+};
+
+#endif
@@ -15,17 +15,19 @@ static std::string getPosString(const Token *tok) {
         .append(")");
 }
 
-ASTPrinter::ASTPrinter(Parser *p) { this->parser = p; }
+ASTPrinter::ASTPrinter(Parser *p, std::ostream &os) : os(os) {
+    this->parser = p;
+}
 
 void ASTPrinter::printIndent() {
     for (int i = 0; i < depth; i++) {
-        std::cout << "    ";
+        os << "    ";
     }
 }
 
 void ASTPrinter::printIndent(int depth) {
     for (int i = 0; i < depth; i++) {
-        std::cout << "    ";
+        os << "    ";
     }
 }
 
@@ -34,12 +36,12 @@ void ASTPrinter::printRuleName(antlr4::ParserRuleContext *ctx, bool withPos) {
     std::transform(name.begin(), name.begin() + 1, name.begin(), ::toupper);
 
     printIndent();
-    std::cout << name;
+    os << name;
     if (withPos) {
         Token *t = ctx->getStart();
-        std::cout << getPosString(t);
+        os << getPosString(t);
     }
-    std::cout << std::endl;
+    os << std::endl;
 }
 
 void ASTPrinter::printString(const std::string &text, Token *posTok) {
@@ -57,7 +59,7 @@ void ASTPrinter::printString(const std::string &text, Token *posTok) {
     }
 
     printIndent();
-    std::cout << content << pos << std::endl;
+    os << content << pos << std::endl;
 }
 
 void ASTPrinter::printString(const std::string &text, Token *posTok,
@@ -72,7 +74,7 @@ void ASTPrinter::printString(const std::string &text, Token *posTok,
 void ASTPrinter::printString(Token *tok) {
     printIndent();
     if (!tok) {
-        std::cout << "<none>" << std::endl;
+        os << "<none>" << std::endl;
     } else {
         std::string pos;
         pos.append(" @ (")
@@ -80,7 +82,7 @@ void ASTPrinter::printString(Token *tok) {
             .append(",")
             .append(std::to_string(tok->getCharPositionInLine() + 1))
             .append(")");
-        std::cout << tok->getText() << pos << std::endl;
+        os << tok->getText() << pos << std::endl;
     }
 }
 
@@ -88,11 +90,11 @@ void ASTPrinter::printList(const std::vector<antlr4::ParserRuleContext *> &v) {
     depth++;
 
     printIndent();
-    std::cout << "List" << std::endl;
+    os << "List" << std::endl;
 
     if (v.size() == 0) {
         printIndent(depth + 1);
-        std::cout << "<empty>" << std::endl;
+        os << "<empty>" << std::endl;
     } else {
         for (ParserRuleContext *x : v) {
             visit(x);
@@ -4,11 +4,13 @@
 #include "DecafParserBaseListener.h"
 #include "DecafParserBaseVisitor.h"
 #include "antlr4-runtime.h"
+#include <ostream>
 #include <vector>
 
 class ASTPrinter : public DecafParserBaseVisitor {
 private:
     antlr4::Parser *parser = nullptr;
+    std::ostream &os;
     int exDepth = 0;
     int depth = -1;
 
@@ -21,7 +23,7 @@ private:
     void printList(const std::vector<antlr4::ParserRuleContext *> &v);
 
 public:
-    ASTPrinter(antlr4::Parser *p);
+    ASTPrinter(antlr4::Parser *p, std::ostream &os);
 
     virtual antlrcpp::Any
     visitTopLevel(DecafParserParser::TopLevelContext *ctx) override;
@@ -1,83 +1,409 @@
 #include "CommonLexer.h"
 #include "printer.h"
 
+#include <climits>
+#include <cstring>
+
 using namespace antlr4;
 
-CommonLexer::CommonLexer(antlr4::CharStream *input) : DecafLexer(input) {}
+namespace {
 
-std::unique_ptr<Token> CommonLexer::nextToken() {
-    std::unique_ptr<Token> tok = DecafLexer::nextToken();
-    ssize_t tokType = tok->getType();
-
-    if (tokType == STRING_LIT) {
-        return checkStringLit(std::move(tok));
-    } else if (tokType == INTLIT) {
-        tok = checkIntLit(std::move(tok));
-    } else if (tokType == UNKNWON_TOKEN) {
-        reportErrorText(getTokenPos(tok.get()),
-                        CompileErrors::UNRECOGNIZED_CHAR, {tok->getText()});
-        lexerFailed = true;
+enum : uint8_t {
+    CH_LETTER = 1,
+    CH_DIGIT = 2,
+    CH_HEX = 4,
+    CH_IDENT = 8,
+    CH_SPACE = 16,
+};
+
+struct CharTable {
+    uint8_t flags[256];
+
+    constexpr CharTable() : flags() {
+        for (int c = 'a'; c <= 'z'; c++) {
+            flags[c] |= CH_LETTER | CH_IDENT;
+            flags[c - 'a' + 'A'] |= CH_LETTER | CH_IDENT;
+        }
+        for (int c = 'a'; c <= 'f'; c++) {
+            flags[c] |= CH_HEX;
+            flags[c - 'a' + 'A'] |= CH_HEX;
+        }
+        for (int c = '0'; c <= '9'; c++) {
+            flags[c] |= CH_DIGIT | CH_HEX | CH_IDENT;
+        }
+        flags['_'] |= CH_IDENT;
+        flags[' '] |= CH_SPACE;
+        flags['\t'] |= CH_SPACE;
+        flags['\r'] |= CH_SPACE;
+        flags['\n'] |= CH_SPACE;
     }
+};
 
-    return tok;
+constexpr CharTable charTable;
+
+inline bool hasFlag(char c, uint8_t flag) {
+    return charTable.flags[static_cast<unsigned char>(c)] & flag;
 }
 
-std::unique_ptr<Token>
-CommonLexer::checkStringLit(std::unique_ptr<Token> startTok) {
-    // begin with STRING_LIT
-    CommonToken *strTok = new CommonToken(startTok->getType());
-    strTok->setLine(startTok->getLine());
-    strTok->setCharPositionInLine(startTok->getCharPositionInLine());
-    strTok->setChannel(startTok->getChannel());
-    strTok->setStartIndex(startTok->getStartIndex());
-    strTok->setStopIndex(startTok->getStopIndex());
-    strTok->setTokenIndex(startTok->getTokenIndex());
-
-    std::unique_ptr<Token> tok = DecafLexer::nextToken();
-    std::string text = strTok->getText();
+struct Keyword {
+    const char *text;
+    size_t length;
+    size_t type;
+};
+
+// Perfect hash of the keywords: (length + first + 3 * last) & 63
+const Keyword keywords[64] = {
+    {},
+    {"class", 5, DecafLexer::CLASS},
+    {"return", 6, DecafLexer::RETURN},
+    {}, {},
+    {"extends", 7, DecafLexer::EXTENDS},
+    {}, {},
+    {"int", 3, DecafLexer::INT},
+    {"ReadLine", 8, DecafLexer::READLINE},
+    {}, {}, {}, {}, {}, {}, {},
+    {"this", 4, DecafLexer::THIS},
+    {}, {}, {}, {},
+    {"new", 3, DecafLexer::NEW},
+    {},
+    {"else", 4, DecafLexer::ELSE},
+    {},
+    {"false", 5, DecafLexer::FALSE},
+    {}, {},
+    {"if", 2, DecafLexer::IF},
+    {}, {}, {}, {},
+    {"static", 6, DecafLexer::STATIC},
+    {}, {},
+    {"instanceof", 10, DecafLexer::INSTANCEOF},
+    {"void", 4, DecafLexer::VOID},
+    {"true", 4, DecafLexer::TRUE},
+    {"break", 5, DecafLexer::BREAK},
+    {},
+    {"bool", 4, DecafLexer::BOOL},
+    {"while", 5, DecafLexer::WHILE},
+    {}, {},
+    {"string", 6, DecafLexer::STRING},
+    {}, {},
+    {"Print", 5, DecafLexer::PRINT},
+    {},
+    {"ReadInteger", 11, DecafLexer::READINTEGER},
+    {}, {},
+    {"null", 4, DecafLexer::NULLLIT},
+    {}, {}, {}, {}, {}, {}, {}, {},
+    {"for", 3, DecafLexer::FOR},
+};
+
+size_t lookupKeyword(const char *text, size_t length) {
+    size_t hash = (length + static_cast<unsigned char>(text[0]) +
+                   3 * static_cast<unsigned char>(text[length - 1])) & 63;
+    const Keyword &kw = keywords[hash];
+
+    if (kw.length == length && std::memcmp(kw.text, text, length) == 0) {
+        return kw.type;
+    }
+    return DecafLexer::IDENTIFIER;
+}
+
+// Escapes allowed in string literals, after the backslash
+inline bool isEscape(char c) {
+    return c == '"' || c == 'n' || c == 't' || c == 'r' || c == '\\';
+}
+
+inline char unescape(char c) {
+    switch (c) {
+    case 'n': return '\n';
+    case 't': return '\t';
+    case 'r': return '\r';
+    default: return c;
+    }
+}
+
+inline unsigned digitValue(char c) {
+    if (c >= 'a') {
+        return c - 'a' + 10;
+    } else if (c >= 'A') {
+        return c - 'A' + 10;
+    }
+    return c - '0';
+}
+
+} // namespace
+
+CommonLexer::CommonLexer(Utf8CharStream *input, LiteralTable &literals)
+    : DecafLexer(input), stream(input), literals(literals),
+      data(input->getData()), length(input->size()) {}
+
+size_t CommonLexer::getLine() const { return line; }
+
+size_t CommonLexer::getCharPositionInLine() { return column; }
+
+void CommonLexer::startToken() {
+    tokenStartCharIndex = pos;
+    tokenStartLine = line;
+    tokenStartCharPositionInLine = column;
+}
+
+std::unique_ptr<Token> CommonLexer::makeToken(size_t type) {
+    return _factory->create({this, _input}, type, "", DEFAULT_TOKEN_CHANNEL,
+                            tokenStartCharIndex, pos - 1, tokenStartLine,
+                            tokenStartCharPositionInLine);
+}
+
+// Consume one code point
+void CommonLexer::consume() {
+    unsigned char c = data[pos];
+    if (c < 0x80) {
+        pos++;
+        if (c == '\n') {
+            line++;
+            column = 0;
+        } else {
+            column++;
+        }
+        return;
+    }
+
+    size_t len;
+    stream->decode(pos, &len);
+    pos += len;
+    column++;
+}
+
+// What the generated lexer does when no rule matches at the token start:
+// report the text up to and including the current code point
+void CommonLexer::notifyNoViableAlt() {
+    stream->seek(pos);
+    notifyListeners(
+        LexerNoViableAltException(this, stream, tokenStartCharIndex, nullptr));
+}
+
+std::unique_ptr<Token> CommonLexer::nextToken() {
     while (true) {
-        if (tok->getType() == ILL_NEWLINE) {
-            text.append(tok->getText());
-            reportErrorText(getTokenPos(tok.get()),
-                            CompileErrors::ILLEGAL_NEWLINE_IN_STR,
-                            {text});
-            lexerFailed = true;
+        startToken();
+        if (pos >= length) {
+            return makeToken(Token::EOF);
+        }
+
+        char c = data[pos];
+        if (hasFlag(c, CH_SPACE)) {
+            while (pos < length && hasFlag(data[pos], CH_SPACE)) {
+                consume();
+            }
+            continue;
+        }
 
-        } else if (tok->getType() == ILL_ESCAPE) {
+        // A comment runs to the end of the line. Without a line end there
+        // is no comment but two divisions
+        if (c == '/' && pos + 1 < length && data[pos + 1] == '/') {
+            const void *nl = std::memchr(data + pos + 2, '\n', length - pos - 2);
+            if (nl != nullptr) {
+                pos = static_cast<const char *>(nl) - data + 1;
+                line++;
+                column = 0;
+                continue;
+            }
+        }
+
+        if (hasFlag(c, CH_LETTER)) {
+            return makeToken(scanIdentifier());
+        } else if (hasFlag(c, CH_DIGIT)) {
+            return scanIntLit();
+        } else if (c == '"') {
+            return scanStringLit();
+        }
+
+        size_t tokType = scanOperator();
+        std::unique_ptr<Token> tok = makeToken(tokType);
+        if (tokType == UNKNWON_TOKEN) {
             reportErrorText(getTokenPos(tok.get()),
-                            CompileErrors::ILLEGAL_ESC_IN_STR,
-                            {text});
-            text.append(tok->getText());
+                            CompileErrors::UNRECOGNIZED_CHAR, {tok->getText()});
             lexerFailed = true;
+        }
+        return tok;
+    }
+}
 
-        } else if (tok->getType() == EOF) {
-            reportErrorText(getTokenPos(startTok.get()),
-                            CompileErrors::UNTERMINATED_STR,
-                            {text});
-            lexerFailed = true;
-            break;
+size_t CommonLexer::scanOperator() {
+    char c = data[pos];
+    char next = pos + 1 < length ? data[pos + 1] : '\0';
+    size_t tokType;
+    size_t len = 1;
 
-        } else if (tok->getType() == STRING_TERM) {
-            break;
+    switch (c) {
+    case '+': tokType = ADD; break;
+    case '-': tokType = SUB; break;
+    case '*': tokType = MUL; break;
+    case '/': tokType = DIV; break;
+    case '%': tokType = MOD; break;
+    case ';': tokType = SEMI; break;
+    case ',': tokType = COMMA; break;
+    case '.': tokType = DOT; break;
+    case '[': tokType = LBRACKET; break;
+    case ']': tokType = RBRACKET; break;
+    case '(': tokType = LPAREN; break;
+    case ')': tokType = RPAREN; break;
+    case '{': tokType = LBRACE; break;
+    case '}': tokType = RBRACE; break;
+    case '<':
+        tokType = next == '=' ? LE : LT;
+        break;
+    case '>':
+        tokType = next == '=' ? GE : GT;
+        break;
+    case '=':
+        tokType = next == '=' ? EQ : ASSIGN;
+        break;
+    case '!':
+        tokType = next == '=' ? NE : NOT;
+        break;
+    case '&':
+        tokType = next == '&' ? AND : UNKNWON_TOKEN;
+        break;
+    case '|':
+        tokType = next == '|' ? OR : UNKNWON_TOKEN;
+        break;
+    default:
+        consume();
+        return UNKNWON_TOKEN;
+    }
 
-        } else if (tok->getType() == ALLOWED_CHARS) {
-            text.append(tok->getText());
-        }
+    if (tokType == LE || tokType == GE || tokType == EQ || tokType == NE ||
+        tokType == AND || tokType == OR) {
+        len = 2;
+    }
+    pos += len;
+    column += len;
+    return tokType;
+}
 
-        tok = DecafLexer::nextToken();
+size_t CommonLexer::scanIdentifier() {
+    size_t start = pos;
+    while (pos < length && hasFlag(data[pos], CH_IDENT)) {
+        pos++;
     }
-    strTok->setText(text);
-    std::unique_ptr<Token> res = std::unique_ptr<Token>(strTok);
-    return res;
+    column += pos - start;
+    return lookupKeyword(data + start, pos - start);
 }
 
-std::unique_ptr<Token> CommonLexer::checkIntLit(std::unique_ptr<Token> tok) {
-    std::string text = tok->getText();
+// Decimal (leading zeros included) or hex, no larger than INT_MAX
+std::unique_ptr<Token> CommonLexer::scanIntLit() {
+    size_t start = pos;
+    unsigned base = 10;
+    uint8_t digitFlag = CH_DIGIT;
+    if (data[pos] == '0' && pos + 2 < length && data[pos + 1] == 'x' &&
+        hasFlag(data[pos + 2], CH_HEX)) {
+        pos += 2;
+        base = 16;
+        digitFlag = CH_HEX;
+    }
 
-    if (isIntegerTooLarge(text)) {
+    uint64_t value = 0;
+    while (pos < length && hasFlag(data[pos], digitFlag)) {
+        value = value * base + digitValue(data[pos]);
+        if (value > INT_MAX) {
+            value = uint64_t(INT_MAX) + 1;
+        }
+        pos++;
+    }
+    column += pos - start;
+
+    std::unique_ptr<Token> tok = makeToken(INTLIT);
+    if (value > INT_MAX) {
         reportErrorText(getTokenPos(tok.get()), CompileErrors::INT_TOO_LARGE,
                         {tok->getText()});
         lexerFailed = true;
     }
+    literals.setIntValue(tok.get(), value);
     return tok;
-}
\ No newline at end of file
+}
+
+// The generated lexer returned the pieces of a string literal in a mode of
+// their own, this joins them into a single STRING_LIT token holding the
+// text between the quotes and reports the same errors. The unescaped value
+// goes to the literal table
+std::unique_ptr<Token> CommonLexer::scanStringLit() {
+    CommonToken *strTok = new CommonToken(STRING_LIT);
+    strTok->setLine(tokenStartLine);
+    strTok->setCharPositionInLine(tokenStartCharPositionInLine);
+    strTok->setStartIndex(pos);
+    strTok->setStopIndex(pos);
+    std::unique_ptr<Token> res = std::unique_ptr<Token>(strTok);
+    Pos startPos = getTokenPos(strTok);
+    consume();
+
+    std::string text;
+    std::string value;
+    while (true) {
+        startToken();
+        if (pos >= length) {
+            reportErrorText(startPos, CompileErrors::UNTERMINATED_STR, {text});
+            lexerFailed = true;
+            break;
+        }
+
+        char c = data[pos];
+        char next = pos + 1 < length ? data[pos + 1] : '\0';
+        size_t start = pos;
+        if (c == '"') {
+            consume();
+            break;
+
+        } else if (c == '\n' || (c == '\r' && next == '\n')) {
+            consume();
+            if (c == '\r') {
+                consume();
+            }
+            text.append(data + start, pos - start);
+            reportErrorText(Pos(tokenStartLine, tokenStartCharPositionInLine),
+                            CompileErrors::ILLEGAL_NEWLINE_IN_STR, {text});
+            lexerFailed = true;
+            continue;
+
+        } else if (c == '\\' && pos + 1 >= length) {
+            consume();
+            notifyNoViableAlt();
+            continue;
+
+        } else if (c == '\\' && !isEscape(next)) {
+            consume();
+            consume();
+            reportErrorText(Pos(tokenStartLine, tokenStartCharPositionInLine),
+                            CompileErrors::ILLEGAL_ESC_IN_STR, {text});
+            text.append(data + start, pos - start);
+            lexerFailed = true;
+            continue;
+
+        } else if (c == '\r') {
+            // Recovery drops the code point after the lone '\r' as well
+            consume();
+            notifyNoViableAlt();
+            if (pos < length) {
+                consume();
+            }
+            continue;
+        }
+
+        while (pos < length) {
+            c = data[pos];
+            if (c == '"' || c == '\n' || c == '\r') {
+                break;
+            } else if (c == '\\') {
+                if (pos + 1 >= length || !isEscape(data[pos + 1])) {
+                    break;
+                }
+                value.push_back(unescape(data[pos + 1]));
+                pos += 2;
+                column += 2;
+            } else {
+                size_t from = pos;
+                consume();
+                value.append(data + from, pos - from);
+            }
+        }
+        text.append(data + start, pos - start);
+    }
+
+    strTok->setText(text);
+    literals.setStringValue(strTok, std::move(value));
+    return res;
+}
@@ -6,17 +6,41 @@
 
 #include "antlr4-runtime.h"
 #include "DecafLexer.h"
+#include "Utf8CharStream.h"
+#include "LiteralTable.h"
 
+// Hand-written scanner for the DecafLexer.g4 vocabulary. It produces the
+// same tokens, positions and errors as the generated lexer plus the string
+// and integer checks, but never runs the ATN simulator: DecafLexer only
+// provides the token types and the recognizer plumbing. Literal values are
+// decoded on the way into the literal table.
 class CommonLexer: public DecafLexer
 {
 public:
     bool lexerFailed = false;
 
-    CommonLexer(antlr4::CharStream *input);
+    CommonLexer(Utf8CharStream *input, LiteralTable &literals);
     virtual std::unique_ptr<antlr4::Token> nextToken() override;
+    virtual size_t getLine() const override;
+    virtual size_t getCharPositionInLine() override;
 
 private:
-    std::unique_ptr<antlr4::Token> checkStringLit(std::unique_ptr<antlr4::Token> startTok);
-    std::unique_ptr<antlr4::Token> checkIntLit(std::unique_ptr<antlr4::Token> tok);
+    Utf8CharStream *stream;
+    LiteralTable &literals;
+    const char *data;
+    size_t length;
+    size_t pos = 0;
+    size_t line = 1;
+    size_t column = 0;
+
+    void startToken();
+    std::unique_ptr<antlr4::Token> makeToken(size_t type);
+    void consume();
+    void notifyNoViableAlt();
+
+    size_t scanOperator();
+    size_t scanIdentifier();
+    std::unique_ptr<antlr4::Token> scanIntLit();
+    std::unique_ptr<antlr4::Token> scanStringLit();
 };
-#endif
\ No newline at end of file
+#endif
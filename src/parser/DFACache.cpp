@@ -0,0 +1,500 @@
+#include "DFACache.h"
+#include "DecafParserParser.h"
+#include "antlr4-runtime.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include <algorithm>
+#include <fstream>
+#include <unordered_map>
+
+#define DFA_CACHE_FILE "decaf.dfa"
+// Bump when the file format changes
+#define DFA_CACHE_VERSION 1
+
+using namespace antlr4;
+using namespace antlr4::atn;
+using antlr4::dfa::DFA;
+using antlr4::dfa::DFAState;
+
+// File layout, one record per line:
+//   decaf-dfa <version> <ATN fingerprint>
+//   context <id> <size> (<parent id + 1, 0 for none> <return state>)*
+//   decision <decision> <state count>
+//   state <accept> <prediction> <requires full ctx> <full ctx> <unique alt>
+//         <has semantic ctx> <dips into outer ctx> <n> <conflicting alt>*
+//         <n> (<ATN state> <alt> <context id> <reaches outer> <semantic>)*
+//         <n> (<alt> <semantic>)*
+//   edges <n> (<symbol> <target + 1, 0 for the error state>)*
+//   start <state>  or  start <precedence> <state>
+//   end
+// Contexts precede the states using them. A semantic context is N (none),
+// P <rule> <predicate> <context dependent> or Q <precedence>.
+
+namespace {
+
+// The shared DFA lives in the parser class, reachable through any instance
+std::vector<DFA> &getSharedDFA(Parser &parser) {
+    return parser.getInterpreter<ParserATNSimulator>()->decisionToDFA;
+}
+
+// Changes whenever the grammar does
+size_t getFingerprint(const ATN &atn) {
+    size_t hash = atn.maxTokenType;
+    auto mix = [&hash](size_t v) { hash = hash * 31 + v; };
+
+    for (ATNState *s : atn.states) {
+        if (s == nullptr) {
+            mix(0);
+            continue;
+        }
+        mix(s->getStateType());
+        mix(s->ruleIndex);
+        for (Transition *t : s->transitions) {
+            mix(t->getSerializationType());
+            mix(t->target->stateNumber);
+        }
+    }
+    return hash;
+}
+
+// Only the predicates left-recursive rules produce are saved
+bool isSavable(const Ref<SemanticContext> &sem) {
+    return sem == SemanticContext::NONE ||
+           dynamic_cast<SemanticContext::Predicate *>(sem.get()) ||
+           dynamic_cast<SemanticContext::PrecedencePredicate *>(sem.get());
+}
+
+bool isSavable(const std::vector<DFAState *> &states) {
+    for (DFAState *s : states) {
+        for (const Ref<ATNConfig> &c : s->configs->configs) {
+            if (!isSavable(c->semanticContext)) {
+                return false;
+            }
+        }
+        for (DFAState::PredPrediction *p : s->predicates) {
+            if (!isSavable(p->pred)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+class Writer {
+public:
+    Writer(std::ostream &os) : os(os) {}
+
+    void writeDFA(const DFA &dfa);
+
+private:
+    std::ostream &os;
+    std::unordered_map<const PredictionContext *, size_t> contextIds;
+
+    size_t writeContext(const Ref<PredictionContext> &ctx);
+    void writeSemantic(const Ref<SemanticContext> &sem);
+};
+
+size_t Writer::writeContext(const Ref<PredictionContext> &ctx) {
+    auto it = contextIds.find(ctx.get());
+    if (it != contextIds.end()) {
+        return it->second;
+    }
+
+    size_t size = ctx->isEmpty() ? 0 : ctx->size();
+    std::vector<size_t> parents;
+    for (size_t i = 0; i < size; i++) {
+        Ref<PredictionContext> parent = ctx->getParent(i);
+        parents.push_back(parent ? writeContext(parent) + 1 : 0);
+    }
+
+    size_t id = contextIds.size();
+    contextIds[ctx.get()] = id;
+    os << "context " << id << " " << size;
+    for (size_t i = 0; i < size; i++) {
+        os << " " << parents[i] << " " << ctx->getReturnState(i);
+    }
+    os << "\n";
+    return id;
+}
+
+void Writer::writeSemantic(const Ref<SemanticContext> &sem) {
+    if (sem == SemanticContext::NONE) {
+        os << " N";
+    } else if (auto pred =
+                   dynamic_cast<SemanticContext::Predicate *>(sem.get())) {
+        os << " P " << pred->ruleIndex << " " << pred->predIndex << " "
+           << pred->isCtxDependent;
+    } else {
+        auto prec =
+            static_cast<SemanticContext::PrecedencePredicate *>(sem.get());
+        os << " Q " << prec->precedence;
+    }
+}
+
+void Writer::writeDFA(const DFA &dfa) {
+    std::vector<DFAState *> states(dfa.states.begin(), dfa.states.end());
+    std::sort(states.begin(), states.end(), [](DFAState *a, DFAState *b) {
+        return a->stateNumber < b->stateNumber;
+    });
+    if (states.empty() || !isSavable(states)) {
+        return;
+    }
+
+    std::unordered_map<DFAState *, size_t> ids;
+    for (DFAState *s : states) {
+        size_t id = ids.size();
+        ids[s] = id;
+        for (const Ref<ATNConfig> &c : s->configs->configs) {
+            writeContext(c->context);
+        }
+    }
+
+    os << "decision " << dfa.decision << " " << states.size() << "\n";
+    for (DFAState *s : states) {
+        ATNConfigSet *configs = s->configs.get();
+        os << "state " << s->isAcceptState << " " << s->prediction << " "
+           << s->requiresFullContext << " " << configs->fullCtx << " "
+           << configs->uniqueAlt << " "
+           << configs->hasSemanticContext << " "
+           << configs->dipsIntoOuterContext << " "
+           << configs->conflictingAlts.count();
+        for (size_t i = 0; i < configs->conflictingAlts.size(); i++) {
+            if (configs->conflictingAlts.test(i)) {
+                os << " " << i;
+            }
+        }
+
+        os << " " << configs->configs.size();
+        for (const Ref<ATNConfig> &c : configs->configs) {
+            os << " " << c->state->stateNumber << " " << c->alt << " "
+               << contextIds[c->context.get()] << " "
+               << c->reachesIntoOuterContext;
+            writeSemantic(c->semanticContext);
+        }
+
+        os << " " << s->predicates.size();
+        for (DFAState::PredPrediction *p : s->predicates) {
+            os << " " << p->alt;
+            writeSemantic(p->pred);
+        }
+        os << "\n";
+    }
+
+    for (DFAState *s : states) {
+        os << "edges " << s->edges.size();
+        for (auto &edge : s->edges) {
+            auto it = ids.find(edge.second);
+            os << " " << edge.first << " "
+               << (it == ids.end() ? 0 : it->second + 1);
+        }
+        os << "\n";
+    }
+
+    if (dfa.isPrecedenceDfa()) {
+        for (auto &edge : dfa.s0->edges) {
+            os << "start " << edge.first << " " << ids[edge.second] << "\n";
+        }
+    } else if (dfa.s0 != nullptr) {
+        os << "start " << ids[dfa.s0] << "\n";
+    }
+    os << "end\n";
+}
+
+// States of one decision, not yet handed over to its DFA
+struct LoadedDFA {
+    size_t decision;
+    std::vector<DFAState *> states;
+    DFAState *s0 = nullptr;
+    std::vector<std::pair<int, DFAState *>> precedenceStarts;
+};
+
+class Reader {
+public:
+    Reader(std::istream &is, const ATN &atn) : is(is), atn(atn) {}
+    ~Reader();
+
+    bool read(std::vector<DFA> &decisionToDFA);
+
+private:
+    std::istream &is;
+    const ATN &atn;
+    std::vector<Ref<PredictionContext>> contexts;
+    std::vector<LoadedDFA> loaded;
+
+    bool readContext();
+    bool readDFA(std::vector<DFA> &decisionToDFA);
+    DFAState *readState();
+    Ref<SemanticContext> readSemantic();
+};
+
+Reader::~Reader() {
+    for (LoadedDFA &l : loaded) {
+        for (DFAState *s : l.states) {
+            delete s;
+        }
+    }
+}
+
+bool Reader::readContext() {
+    size_t id, size;
+    if (!(is >> id >> size) || id != contexts.size()) {
+        return false;
+    }
+    if (size == 0) {
+        contexts.push_back(PredictionContext::EMPTY);
+        return true;
+    }
+
+    std::vector<Ref<PredictionContext>> parents;
+    std::vector<size_t> returnStates;
+    for (size_t i = 0; i < size; i++) {
+        size_t parent, returnState;
+        if (!(is >> parent >> returnState) || parent > contexts.size()) {
+            return false;
+        }
+        parents.push_back(parent == 0 ? nullptr : contexts[parent - 1]);
+        returnStates.push_back(returnState);
+    }
+
+    if (size == 1) {
+        contexts.push_back(
+            SingletonPredictionContext::create(parents[0], returnStates[0]));
+    } else {
+        contexts.push_back(
+            std::make_shared<ArrayPredictionContext>(parents, returnStates));
+    }
+    return true;
+}
+
+Ref<SemanticContext> Reader::readSemantic() {
+    std::string kind;
+    is >> kind;
+    if (kind == "N") {
+        return SemanticContext::NONE;
+    } else if (kind == "P") {
+        size_t rule, pred;
+        bool ctxDependent;
+        if (is >> rule >> pred >> ctxDependent) {
+            return std::make_shared<SemanticContext::Predicate>(rule, pred,
+                                                                ctxDependent);
+        }
+    } else if (kind == "Q") {
+        int precedence;
+        if (is >> precedence) {
+            return std::make_shared<SemanticContext::PrecedencePredicate>(
+                precedence);
+        }
+    }
+    return nullptr;
+}
+
+DFAState *Reader::readState() {
+    std::string tag;
+    bool accept, requiresFullCtx, fullCtx, hasSem, dips;
+    size_t prediction, uniqueAlt, count;
+    if (!(is >> tag >> accept >> prediction >> requiresFullCtx >> fullCtx >>
+          uniqueAlt >> hasSem >> dips >> count) ||
+        tag != "state") {
+        return nullptr;
+    }
+
+    std::unique_ptr<ATNConfigSet> configs(new ATNConfigSet(fullCtx));
+    for (size_t i = 0; i < count; i++) {
+        size_t alt;
+        if (!(is >> alt) || alt >= configs->conflictingAlts.size()) {
+            return nullptr;
+        }
+        configs->conflictingAlts.set(alt);
+    }
+
+    if (!(is >> count)) {
+        return nullptr;
+    }
+    for (size_t i = 0; i < count; i++) {
+        size_t state, alt, ctx, reaches;
+        if (!(is >> state >> alt >> ctx >> reaches) ||
+            state >= atn.states.size() || ctx >= contexts.size()) {
+            return nullptr;
+        }
+        Ref<SemanticContext> sem = readSemantic();
+        if (sem == nullptr) {
+            return nullptr;
+        }
+        auto config = std::make_shared<ATNConfig>(atn.states[state], alt,
+                                                  contexts[ctx], sem);
+        config->reachesIntoOuterContext = reaches;
+        configs->add(config);
+    }
+    configs->uniqueAlt = uniqueAlt;
+    configs->hasSemanticContext = hasSem;
+    configs->dipsIntoOuterContext = dips;
+    configs->setReadonly(true);
+
+    DFAState *s = new DFAState(std::move(configs));
+    s->isAcceptState = accept;
+    s->prediction = prediction;
+    s->requiresFullContext = requiresFullCtx;
+    if (!(is >> count)) {
+        delete s;
+        return nullptr;
+    }
+    for (size_t i = 0; i < count; i++) {
+        int alt;
+        Ref<SemanticContext> sem;
+        if (!(is >> alt) || (sem = readSemantic()) == nullptr) {
+            delete s;
+            return nullptr;
+        }
+        s->predicates.push_back(new DFAState::PredPrediction(sem, alt));
+    }
+    return s;
+}
+
+bool Reader::readDFA(std::vector<DFA> &decisionToDFA) {
+    size_t decision, count;
+    if (!(is >> decision >> count) || decision >= decisionToDFA.size()) {
+        return false;
+    }
+    DFA &dfa = decisionToDFA[decision];
+    loaded.emplace_back();
+    LoadedDFA &l = loaded.back();
+    l.decision = decision;
+
+    for (size_t i = 0; i < count; i++) {
+        DFAState *s = readState();
+        if (s == nullptr) {
+            return false;
+        }
+        s->stateNumber = i;
+        l.states.push_back(s);
+    }
+
+    std::string tag;
+    for (DFAState *s : l.states) {
+        if (!(is >> tag >> count) || tag != "edges") {
+            return false;
+        }
+        for (size_t i = 0; i < count; i++) {
+            size_t symbol, target;
+            if (!(is >> symbol >> target) || target > l.states.size()) {
+                return false;
+            }
+            s->edges[symbol] = target == 0 ? ATNSimulator::ERROR.get()
+                                           : l.states[target - 1];
+        }
+    }
+
+    while (is >> tag && tag == "start") {
+        int precedence = 0;
+        size_t id;
+        if (dfa.isPrecedenceDfa() && !(is >> precedence)) {
+            return false;
+        }
+        if (!(is >> id) || id >= l.states.size()) {
+            return false;
+        }
+        if (dfa.isPrecedenceDfa()) {
+            l.precedenceStarts.emplace_back(precedence, l.states[id]);
+        } else {
+            l.s0 = l.states[id];
+        }
+    }
+    return tag == "end";
+}
+
+bool Reader::read(std::vector<DFA> &decisionToDFA) {
+    std::string tag;
+    while (is >> tag) {
+        if (tag == "context") {
+            if (!readContext()) {
+                return false;
+            }
+        } else if (tag == "decision") {
+            if (!readDFA(decisionToDFA)) {
+                return false;
+            }
+        } else {
+            return false;
+        }
+    }
+
+    // Everything parsed, hand the states over
+    for (LoadedDFA &l : loaded) {
+        DFA &dfa = decisionToDFA[l.decision];
+        if (!dfa.states.empty()) {
+            continue;
+        }
+        for (DFAState *s : l.states) {
+            dfa.states.insert(s);
+        }
+        if (dfa.isPrecedenceDfa()) {
+            for (auto &start : l.precedenceStarts) {
+                dfa.s0->edges[start.first] = start.second;
+            }
+        } else {
+            dfa.s0 = l.s0;
+        }
+        l.states.clear();
+    }
+    return true;
+}
+
+} // namespace
+
+bool DFACache::load(const std::string &path) {
+    std::ifstream ifs(path);
+    if (!ifs.is_open()) {
+        return false;
+    }
+
+    DecafParserParser parser(nullptr);
+    const ATN &atn = parser.getATN();
+    std::string magic;
+    int version;
+    size_t fingerprint;
+    if (!(ifs >> magic >> version >> fingerprint) || magic != "decaf-dfa" ||
+        version != DFA_CACHE_VERSION || fingerprint != getFingerprint(atn)) {
+        return false;
+    }
+
+    Reader reader(ifs, atn);
+    return reader.read(getSharedDFA(parser));
+}
+
+bool DFACache::save(const std::string &path) {
+    llvm::SmallString<128> tmp;
+    if (llvm::sys::fs::createUniqueFile(path + "-%%%%%%%%.tmp", tmp)) {
+        return false;
+    }
+
+    DecafParserParser parser(nullptr);
+    {
+        std::ofstream ofs(tmp.str().str());
+        ofs << "decaf-dfa " << DFA_CACHE_VERSION << " "
+            << getFingerprint(parser.getATN()) << "\n";
+        Writer writer(ofs);
+        for (const DFA &dfa : getSharedDFA(parser)) {
+            writer.writeDFA(dfa);
+        }
+        ofs.close();
+        if (!ofs) {
+            llvm::sys::fs::remove(tmp);
+            return false;
+        }
+    }
+
+    if (llvm::sys::fs::rename(tmp, path)) {
+        llvm::sys::fs::remove(tmp);
+        return false;
+    }
+    return true;
+}
+
+std::string DFACache::getDefaultPath() {
+    std::string exePath = llvm::sys::fs::getMainExecutable(
+        nullptr, (void *)(intptr_t)&DFACache::getDefaultPath);
+    llvm::SmallString<128> path(llvm::sys::path::parent_path(exePath));
+    llvm::sys::path::append(path, DFA_CACHE_FILE);
+    return path.str().str();
+}
@@ -0,0 +1,21 @@
+#ifndef _DFA_CACHE_H_
+#define _DFA_CACHE_H_
+
+#include <string>
+
+// Keeps the prediction DFA that ANTLR builds up while parsing across runs.
+// All DecafParserParser instances of a process share one DFA, so saving it
+// after a run and loading it before the next spares the first parses the
+// ATN simulation of every decision they meet.
+class DFACache {
+public:
+    // Fill the shared DFA, which must not have been used yet. Caches written
+    // for another grammar are ignored
+    static bool load(const std::string &path);
+    // Write the shared DFA, replacing path atomically
+    static bool save(const std::string &path);
+    // decaf.dfa next to the decaf binary, used when no cache is given
+    static std::string getDefaultPath();
+};
+
+#endif
@@ -0,0 +1,48 @@
+#include "DecisionProfile.h"
+#include "antlr4-runtime.h"
+#include <algorithm>
+#include <iomanip>
+
+using namespace antlr4;
+using antlr4::atn::DecisionInfo;
+
+void enableDecisionProfile(Parser &parser) {
+    // Keeps the prediction mode and the shared DFA of the old simulator
+    parser.setProfile(true);
+}
+
+void printDecisionProfile(const Parser &parser, std::ostream &os) {
+    std::vector<DecisionInfo> infos = parser.getParseInfo().getDecisionInfo();
+    std::vector<const DecisionInfo *> decisions;
+    for (auto &d : infos) {
+        if (d.invocations > 0) {
+            decisions.push_back(&d);
+        }
+    }
+    std::stable_sort(decisions.begin(), decisions.end(),
+                     [](const DecisionInfo *a, const DecisionInfo *b) {
+                         return a->timeInPrediction > b->timeInPrediction;
+                     });
+
+    const atn::ATN &atn = parser.getATN();
+    const std::vector<std::string> &ruleNames = parser.getRuleNames();
+
+    // Lookahead is in tokens. An LL fallback is an SLL prediction that met
+    // a conflict and was retried with full context
+    os << "===---------------------------------------------------------===\n"
+       << "                  Decaf parser decision profile\n"
+       << "===---------------------------------------------------------===\n"
+       << "   Time (ms)  Invocations  LL fallbacks  SLL max look  "
+          "LL max look  Ambiguities  Decision  Rule\n";
+    os << std::fixed << std::setprecision(3);
+    for (const DecisionInfo *d : decisions) {
+        size_t rule = atn.decisionToState[d->decision]->ruleIndex;
+        os << std::setw(12) << d->timeInPrediction / 1e6 << std::setw(13)
+           << d->invocations << std::setw(14) << d->LL_Fallback
+           << std::setw(14) << d->SLL_MaxLook << std::setw(13)
+           << d->LL_MaxLook << std::setw(13) << d->ambiguities.size()
+           << std::setw(10) << d->decision << "  " << ruleNames[rule] << "\n";
+    }
+    os.unsetf(std::ios::floatfield);
+    os << std::flush;
+}
@@ -0,0 +1,18 @@
+#ifndef _DECISION_PROFILE_H_
+#define _DECISION_PROFILE_H_
+
+#include <ostream>
+
+namespace antlr4 {
+class Parser;
+}
+
+// Per-decision statistics of the prediction, printed by --profile-parser.
+// Switches parser to the profiling ATN simulator, which must happen before
+// it parses anything
+void enableDecisionProfile(antlr4::Parser &parser);
+// Decisions the parser predicted at, the slowest first, with the rule of
+// DecafParser.g4 each one is in
+void printDecisionProfile(const antlr4::Parser &parser, std::ostream &os);
+
+#endif
@@ -0,0 +1,593 @@
+#include "DescentParser.h"
+#include "Pos.h"
+
+using namespace antlr4;
+
+// Binary operators by precedence, higher binds tighter, 0 for other tokens.
+// The order of the binary alternatives of the expr rule
+static int getBinaryPrec(size_t type) {
+    switch (type) {
+    case DecafLexer::MUL:
+    case DecafLexer::DIV:
+    case DecafLexer::MOD:
+        return 6;
+    case DecafLexer::ADD:
+    case DecafLexer::SUB:
+        return 5;
+    case DecafLexer::LE:
+    case DecafLexer::LT:
+    case DecafLexer::GE:
+    case DecafLexer::GT:
+        return 4;
+    case DecafLexer::EQ:
+    case DecafLexer::NE:
+        return 3;
+    case DecafLexer::AND:
+        return 2;
+    case DecafLexer::OR:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+static Binary::Op getBinaryOp(size_t type) {
+    switch (type) {
+    case DecafLexer::MUL:
+        return Binary::MUL;
+    case DecafLexer::DIV:
+        return Binary::DIV;
+    case DecafLexer::MOD:
+        return Binary::MOD;
+    case DecafLexer::ADD:
+        return Binary::ADD;
+    case DecafLexer::SUB:
+        return Binary::SUB;
+    case DecafLexer::LE:
+        return Binary::LE;
+    case DecafLexer::LT:
+        return Binary::LT;
+    case DecafLexer::GE:
+        return Binary::GE;
+    case DecafLexer::GT:
+        return Binary::GT;
+    case DecafLexer::EQ:
+        return Binary::EQ;
+    case DecafLexer::NE:
+        return Binary::NE;
+    case DecafLexer::AND:
+        return Binary::AND;
+    default:
+        return Binary::OR;
+    }
+}
+
+// Quoted token text as antlr's error strategy shows it
+static std::string getTokenDisplay(const Token *tok) {
+    if (tok->getType() == Token::EOF) {
+        return "'<EOF>'";
+    }
+    std::string s = "'";
+    for (char c : tok->getText()) {
+        if (c == '\n') {
+            s += "\\n";
+        } else if (c == '\r') {
+            s += "\\r";
+        } else if (c == '\t') {
+            s += "\\t";
+        } else {
+            s += c;
+        }
+    }
+    return s + "'";
+}
+
+DescentParser::DescentParser(CommonLexer &lexer, const LiteralTable &literals,
+                             ASTContext &ast)
+    : lexer(lexer), literals(literals), ast(ast) {}
+
+TopLevel *DescentParser::parse() {
+    advance();
+
+    TopLevel *root = nullptr;
+    try {
+        Pos pos = getPos();
+        std::vector<ClassDef *> classes;
+        // topLevel doesn't end in EOF, anything after the last class is left
+        // alone like the generated parser does
+        do {
+            classes.push_back(parseClassDef());
+        } while (at(DecafLexer::CLASS));
+        root = ast.create<TopLevel>(pos, ast.copyArray(classes));
+        ast.root = root;
+    } catch (SyntaxError &) {
+    }
+
+    while (!at(Token::EOF)) {
+        advance();
+    }
+    return root;
+}
+
+void DescentParser::advance() { tok = lexer.nextToken(); }
+
+bool DescentParser::accept(size_t type) {
+    if (!at(type)) {
+        return false;
+    }
+    advance();
+    return true;
+}
+
+Pos DescentParser::expect(size_t type) {
+    if (!at(type)) {
+        fail("mismatched input " + getTokenDisplay(tok.get()) +
+             " expecting " + lexer.getVocabulary().getDisplayName(type));
+    }
+    Pos pos = getPos();
+    advance();
+    return pos;
+}
+
+Name DescentParser::expectName(Pos *pos) {
+    if (!at(DecafLexer::IDENTIFIER)) {
+        expect(DecafLexer::IDENTIFIER);
+    }
+    if (pos) {
+        *pos = getPos();
+    }
+    Name name = ast.intern(tok->getText());
+    advance();
+    return name;
+}
+
+void DescentParser::fail(const std::string &msg) {
+    error = "line " + std::to_string(tok->getLine()) + ":" +
+            std::to_string(tok->getCharPositionInLine()) + " " + msg + "\n";
+    throw SyntaxError();
+}
+
+void DescentParser::failNoViableAlt() {
+    fail("no viable alternative at input " + getTokenDisplay(tok.get()));
+}
+
+ClassDef *DescentParser::parseClassDef() {
+    Pos pos = expect(DecafLexer::CLASS);
+    Name name = expectName();
+    Name baseName;
+    if (accept(DecafLexer::EXTENDS)) {
+        baseName = expectName();
+    }
+
+    expect(DecafLexer::LBRACE);
+    std::vector<ASTNode *> fields;
+    while (!accept(DecafLexer::RBRACE)) {
+        fields.push_back(parseField());
+    }
+    return ast.create<ClassDef>(pos, name, baseName, ast.copyArray(fields));
+}
+
+// varDef and methodDef share 'type id', the token after it decides
+ASTNode *DescentParser::parseField() {
+    bool isStatic = accept(DecafLexer::STATIC);
+    if (!atType()) {
+        failNoViableAlt();
+    }
+    TypeLit *type = parseType();
+    Pos pos;
+    Name name = expectName(&pos);
+
+    if (!isStatic && accept(DecafLexer::SEMI)) {
+        return ast.create<VarDef>(pos, type, name);
+    }
+
+    expect(DecafLexer::LPAREN);
+    std::vector<VarDef *> params;
+    if (!at(DecafLexer::RPAREN)) {
+        do {
+            TypeLit *paramType = parseType();
+            Pos paramPos;
+            Name paramName = expectName(&paramPos);
+            params.push_back(
+                ast.create<VarDef>(paramPos, paramType, paramName));
+        } while (accept(DecafLexer::COMMA));
+    }
+    expect(DecafLexer::RPAREN);
+    return ast.create<MethodDef>(pos, isStatic, type, name,
+                                 ast.copyArray(params), parseBlock());
+}
+
+bool DescentParser::atType() const {
+    switch (peek()) {
+    case DecafLexer::INT:
+    case DecafLexer::BOOL:
+    case DecafLexer::STRING:
+    case DecafLexer::VOID:
+    case DecafLexer::CLASS:
+        return true;
+    default:
+        return false;
+    }
+}
+
+TypeLit *DescentParser::parseType() {
+    TypeLit *type = parseBaseType();
+    while (accept(DecafLexer::LBRACKET)) {
+        expect(DecafLexer::RBRACKET);
+        TypeLit *array = ast.create<TypeLit>(type->pos, TypeLit::ARRAY);
+        array->elem = type;
+        type = array;
+    }
+    return type;
+}
+
+TypeLit *DescentParser::parseBaseType() {
+    Pos pos = getPos();
+    TypeLit::Base base;
+
+    switch (peek()) {
+    case DecafLexer::INT:
+        base = TypeLit::INT;
+        break;
+    case DecafLexer::BOOL:
+        base = TypeLit::BOOL;
+        break;
+    case DecafLexer::STRING:
+        base = TypeLit::STRING;
+        break;
+    case DecafLexer::VOID:
+        base = TypeLit::VOID;
+        break;
+    case DecafLexer::CLASS: {
+        advance();
+        TypeLit *type = ast.create<TypeLit>(pos, TypeLit::CLASS);
+        type->className = expectName();
+        return type;
+    }
+    default:
+        failNoViableAlt();
+    }
+    advance();
+    return ast.create<TypeLit>(pos, base);
+}
+
+Block *DescentParser::parseBlock() {
+    Pos pos = expect(DecafLexer::LBRACE);
+    std::vector<Stmt *> stmts;
+
+    while (!accept(DecafLexer::RBRACE)) {
+        // Types and expressions start with different tokens
+        if (atType()) {
+            stmts.push_back(parseLocalVarDef());
+            expect(DecafLexer::SEMI);
+        } else {
+            stmts.push_back(parseStmt());
+        }
+    }
+    return ast.create<Block>(pos, ast.copyArray(stmts));
+}
+
+Stmt *DescentParser::parseStmt() {
+    Pos pos = getPos();
+
+    switch (peek()) {
+    case DecafLexer::LBRACE:
+        return parseBlock();
+    case DecafLexer::SEMI:
+        advance();
+        return ast.create<EmptyStmt>(pos);
+    case DecafLexer::IF: {
+        advance();
+        expect(DecafLexer::LPAREN);
+        Expr *cond = parseExpr();
+        expect(DecafLexer::RPAREN);
+        Stmt *thenStmt = parseStmt();
+        Stmt *elseStmt = accept(DecafLexer::ELSE) ? parseStmt() : nullptr;
+        return ast.create<IfStmt>(pos, cond, thenStmt, elseStmt);
+    }
+    case DecafLexer::WHILE: {
+        advance();
+        expect(DecafLexer::LPAREN);
+        Expr *cond = parseExpr();
+        expect(DecafLexer::RPAREN);
+        return ast.create<WhileStmt>(pos, cond, parseStmt());
+    }
+    case DecafLexer::FOR:
+        return parseFor();
+    case DecafLexer::BREAK:
+        advance();
+        expect(DecafLexer::SEMI);
+        return ast.create<BreakStmt>(pos);
+    case DecafLexer::RETURN: {
+        advance();
+        Expr *expr = at(DecafLexer::SEMI) ? nullptr : parseExpr();
+        expect(DecafLexer::SEMI);
+        return ast.create<ReturnStmt>(pos, expr);
+    }
+    case DecafLexer::PRINT: {
+        advance();
+        expect(DecafLexer::LPAREN);
+        std::vector<Expr *> args = parseExprList();
+        expect(DecafLexer::RPAREN);
+        expect(DecafLexer::SEMI);
+        return ast.create<PrintStmt>(pos, ast.copyArray(args));
+    }
+    default: {
+        Stmt *stmt = parseSimpleStmt(true);
+        expect(DecafLexer::SEMI);
+        return stmt;
+    }
+    }
+}
+
+LocalVarDef *DescentParser::parseLocalVarDef() {
+    TypeLit *type = parseType();
+    Pos pos;
+    Name name = expectName(&pos);
+    VarDef *var = ast.create<VarDef>(pos, type, name);
+
+    Expr *init = nullptr;
+    Pos opPos;
+    if (at(DecafLexer::ASSIGN)) {
+        opPos = getPos();
+        advance();
+        init = parseExpr();
+    }
+    return ast.create<LocalVarDef>(var, init, opPos);
+}
+
+// An assignment, or with allowExpr an expression statement. Both start with
+// an expression, an lValue being one too, and '=' tells them apart
+Stmt *DescentParser::parseSimpleStmt(bool allowExpr) {
+    Expr *expr = parseExpr();
+    if (!at(DecafLexer::ASSIGN)) {
+        if (!allowExpr) {
+            expect(DecafLexer::ASSIGN);
+        }
+        return ast.create<ExprStmt>(expr);
+    }
+
+    Expr *lValue = toLValue(expr);
+    if (!lValue) {
+        failNoViableAlt();
+    }
+    Pos opPos = getPos();
+    advance();
+    return ast.create<Assign>(lValue, parseExpr(), opPos);
+}
+
+// lValue is '(expr DOT)? id' or 'expr [expr]' with expr any expression, so
+// the selection made last in the source is the one assigned to, whatever
+// operators come before it: '-a.b = 1' assigns field b of -a. Expressions
+// are parsed with the selection bound tighter, so move it to the top
+Expr *DescentParser::toLValue(Expr *expr) {
+    Expr **link = &expr;
+    while (true) {
+        Expr *e = *link;
+        if (e->kind == ASTNode::UNARY) {
+            link = &static_cast<Unary *>(e)->operand;
+        } else if (e->kind == ASTNode::BINARY) {
+            link = &static_cast<Binary *>(e)->rhs;
+        } else if (e->kind == ASTNode::CAST) {
+            link = &static_cast<Cast *>(e)->expr;
+        } else {
+            break;
+        }
+    }
+
+    Expr *sel = *link;
+    if (sel->kind == ASTNode::INDEX_SEL) {
+        auto *index = static_cast<IndexSel *>(sel);
+        if (link != &expr) {
+            *link = index->array;
+            index->array = expr;
+            index->pos = expr->pos;
+        }
+        return index;
+    }
+    if (sel->kind == ASTNode::VAR_SEL) {
+        auto *var = static_cast<VarSel *>(sel);
+        if (link != &expr) {
+            if (!var->receiver) {
+                return nullptr;
+            }
+            *link = var->receiver;
+            var->receiver = expr;
+            var->pos = expr->pos;
+        }
+        return var;
+    }
+    return nullptr;
+}
+
+Stmt *DescentParser::parseFor() {
+    Pos pos = expect(DecafLexer::FOR);
+    expect(DecafLexer::LPAREN);
+
+    Stmt *init = nullptr;
+    if (atType()) {
+        init = parseLocalVarDef();
+    } else if (!at(DecafLexer::SEMI)) {
+        init = parseSimpleStmt(false);
+    }
+    expect(DecafLexer::SEMI);
+    Expr *cond = parseExpr();
+    expect(DecafLexer::SEMI);
+    Stmt *update = at(DecafLexer::RPAREN) ? nullptr : parseSimpleStmt(true);
+    expect(DecafLexer::RPAREN);
+
+    return ast.create<ForStmt>(pos, init, cond, update, parseStmt());
+}
+
+// Precedence climbing over the binary operators, all left associative
+Expr *DescentParser::parseExpr(int minPrec) {
+    Expr *lhs = parseUnary();
+    for (int prec = getBinaryPrec(peek()); prec >= minPrec;
+         prec = getBinaryPrec(peek())) {
+        Binary::Op op = getBinaryOp(peek());
+        Pos opPos = getPos();
+        advance();
+        Expr *rhs = parseExpr(prec + 1);
+        lhs = ast.create<Binary>(op, lhs, rhs, opPos);
+    }
+    return lhs;
+}
+
+// Prefix operators bind looser than selections and calls, which are parsed
+// along with their operand
+Expr *DescentParser::parseUnary() {
+    Pos pos = getPos();
+
+    switch (peek()) {
+    case DecafLexer::NOT:
+        advance();
+        return ast.create<Unary>(pos, Unary::NOT, parseUnary());
+    case DecafLexer::SUB:
+        advance();
+        return ast.create<Unary>(pos, Unary::NEG, parseUnary());
+    case DecafLexer::LPAREN: {
+        // '(' CLASS is a cast, any other '(' a parenthesized expression
+        advance();
+        if (accept(DecafLexer::CLASS)) {
+            Pos classPos;
+            Name className = expectName(&classPos);
+            expect(DecafLexer::RPAREN);
+            return ast.create<Cast>(pos, className, classPos, parseUnary());
+        }
+        Expr *expr = parseExpr();
+        expect(DecafLexer::RPAREN);
+        return parsePostfix(ast.create<Paren>(pos, expr));
+    }
+    default:
+        return parsePostfix(parsePrimary());
+    }
+}
+
+Expr *DescentParser::parsePostfix(Expr *expr) {
+    while (true) {
+        if (at(DecafLexer::DOT)) {
+            advance();
+            Pos namePos;
+            Name name = expectName(&namePos);
+            if (at(DecafLexer::LPAREN)) {
+                Pos lparenPos = getPos();
+                advance();
+                std::vector<Expr *> args = parseExprList();
+                expect(DecafLexer::RPAREN);
+                expr = ast.create<Call>(expr->pos, expr, name, namePos,
+                                        lparenPos, ast.copyArray(args));
+            } else {
+                expr = ast.create<VarSel>(expr->pos, expr, name, namePos);
+            }
+        } else if (at(DecafLexer::LBRACKET)) {
+            Pos opPos = getPos();
+            advance();
+            Expr *index = parseExpr();
+            expect(DecafLexer::RBRACKET);
+            expr = ast.create<IndexSel>(expr, index, opPos);
+        } else {
+            return expr;
+        }
+    }
+}
+
+Expr *DescentParser::parsePrimary() {
+    Pos pos = getPos();
+
+    switch (peek()) {
+    case DecafLexer::INTLIT: {
+        int value = literals.getIntValue(tok.get());
+        advance();
+        return ast.create<IntLit>(pos, value);
+    }
+    case DecafLexer::TRUE:
+    case DecafLexer::FALSE: {
+        bool value = at(DecafLexer::TRUE);
+        advance();
+        return ast.create<BoolLit>(pos, value);
+    }
+    case DecafLexer::NULLLIT:
+        advance();
+        return ast.create<NullLit>(pos);
+    case DecafLexer::STRING_LIT: {
+        llvm::StringRef value = ast.save(literals.getStringValue(tok.get()));
+        advance();
+        return ast.create<StringLit>(pos, value);
+    }
+    case DecafLexer::THIS:
+        advance();
+        return ast.create<ThisExpr>(pos);
+    case DecafLexer::IDENTIFIER: {
+        Name name = expectName();
+        if (!at(DecafLexer::LPAREN)) {
+            return ast.create<VarSel>(pos, nullptr, name, pos);
+        }
+        Pos lparenPos = getPos();
+        advance();
+        std::vector<Expr *> args = parseExprList();
+        expect(DecafLexer::RPAREN);
+        return ast.create<Call>(pos, nullptr, name, pos, lparenPos,
+                                ast.copyArray(args));
+    }
+    case DecafLexer::READINTEGER:
+        advance();
+        expect(DecafLexer::LPAREN);
+        expect(DecafLexer::RPAREN);
+        return ast.create<ReadInt>(pos);
+    case DecafLexer::READLINE:
+        advance();
+        expect(DecafLexer::LPAREN);
+        expect(DecafLexer::RPAREN);
+        return ast.create<ReadLine>(pos);
+    case DecafLexer::NEW:
+        return parseNew();
+    case DecafLexer::INSTANCEOF: {
+        advance();
+        expect(DecafLexer::LPAREN);
+        Expr *expr = parseExpr();
+        expect(DecafLexer::COMMA);
+        Pos classPos;
+        Name className = expectName(&classPos);
+        expect(DecafLexer::RPAREN);
+        return ast.create<Instanceof>(pos, expr, className, classPos);
+    }
+    default:
+        failNoViableAlt();
+    }
+}
+
+// new <id>() or new <type>[<expr>]. The element type ends at the first '['
+// that is not followed by ']'
+Expr *DescentParser::parseNew() {
+    Pos pos = expect(DecafLexer::NEW);
+
+    if (at(DecafLexer::IDENTIFIER)) {
+        Name className = expectName();
+        expect(DecafLexer::LPAREN);
+        expect(DecafLexer::RPAREN);
+        return ast.create<ClassNew>(pos, className);
+    }
+
+    TypeLit *elemType = parseBaseType();
+    expect(DecafLexer::LBRACKET);
+    while (accept(DecafLexer::RBRACKET)) {
+        TypeLit *array = ast.create<TypeLit>(elemType->pos, TypeLit::ARRAY);
+        array->elem = elemType;
+        elemType = array;
+        expect(DecafLexer::LBRACKET);
+    }
+    Expr *length = parseExpr();
+    expect(DecafLexer::RBRACKET);
+    return ast.create<ArrayNew>(pos, elemType, length);
+}
+
+std::vector<Expr *> DescentParser::parseExprList() {
+    std::vector<Expr *> exprs;
+    if (at(DecafLexer::RPAREN)) {
+        return exprs;
+    }
+    do {
+        exprs.push_back(parseExpr());
+    } while (accept(DecafLexer::COMMA));
+    return exprs;
+}
@@ -0,0 +1,71 @@
+#ifndef _DESCENT_PARSER_H_
+#define _DESCENT_PARSER_H_
+
+#include "CommonLexer.h"
+#include "LiteralTable.h"
+#include "antlr4-runtime.h"
+#include "ast/AST.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// Hand-written recursive descent parser for DecafParser.g4, building the AST
+// directly instead of a parse tree. The grammar is left-factored so that
+// every decision looks at the current token only, and expressions are
+// parsed by precedence climbing in the precedence order of the expr rule.
+// It accepts the same programs as the generated parser and builds the same
+// AST as ASTBuilder, but stops at the first syntax error without recovery.
+class DescentParser {
+public:
+    DescentParser(CommonLexer &lexer, const LiteralTable &literals,
+                  ASTContext &ast);
+
+    // Null on a syntax error. The rest of the input is lexed anyway, so that
+    // every lexical error is reported
+    TopLevel *parse();
+
+    // The syntax error, in the format of antlr's error listeners
+    const std::string &getError() const { return error; }
+
+private:
+    // Thrown to unwind the parse at the first syntax error
+    struct SyntaxError {};
+
+    CommonLexer &lexer;
+    const LiteralTable &literals;
+    ASTContext &ast;
+    std::unique_ptr<antlr4::Token> tok;
+    std::string error;
+
+    size_t peek() const { return tok->getType(); }
+    bool at(size_t type) const { return tok->getType() == type; }
+    Pos getPos() const { return getTokenPos(tok.get()); }
+    void advance();
+    bool accept(size_t type);
+    Pos expect(size_t type);
+    Name expectName(Pos *pos = nullptr);
+    [[noreturn]] void fail(const std::string &msg);
+    [[noreturn]] void failNoViableAlt();
+
+    ClassDef *parseClassDef();
+    ASTNode *parseField();
+    TypeLit *parseType();
+    TypeLit *parseBaseType();
+    bool atType() const;
+
+    Block *parseBlock();
+    Stmt *parseStmt();
+    LocalVarDef *parseLocalVarDef();
+    Stmt *parseSimpleStmt(bool allowExpr);
+    Expr *toLValue(Expr *expr);
+    Stmt *parseFor();
+
+    Expr *parseExpr(int minPrec = 1);
+    Expr *parseUnary();
+    Expr *parsePostfix(Expr *expr);
+    Expr *parsePrimary();
+    Expr *parseNew();
+    std::vector<Expr *> parseExprList();
+};
+
+#endif
@@ -0,0 +1,27 @@
+#include "DiagErrorListener.h"
+#include "printer.h"
+
+DiagErrorListener DiagErrorListener::INSTANCE;
+
+void DiagErrorListener::syntaxError(antlr4::Recognizer *recognizer,
+                                    antlr4::Token *offendingSymbol,
+                                    size_t line, size_t charPositionInLine,
+                                    const std::string &msg,
+                                    std::exception_ptr e) {
+    getDiagnosticStream() << "line " << line << ":" << charPositionInLine
+                          << " " << msg << std::endl;
+}
+
+void DeferredErrorListener::syntaxError(antlr4::Recognizer *recognizer,
+                                        antlr4::Token *offendingSymbol,
+                                        size_t line, size_t charPositionInLine,
+                                        const std::string &msg,
+                                        std::exception_ptr e) {
+    errors << "line " << line << ":" << charPositionInLine << " " << msg
+           << std::endl;
+}
+
+void DeferredErrorListener::flush() {
+    getDiagnosticStream() << errors.str() << std::flush;
+    errors.str("");
+}
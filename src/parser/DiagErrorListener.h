@@ -0,0 +1,36 @@
+#ifndef _DIAG_ERROR_LISTENER_H_
+#define _DIAG_ERROR_LISTENER_H_
+
+#include "antlr4-runtime.h"
+#include <sstream>
+
+// Same as antlr4::ConsoleErrorListener, but prints to the diagnostic stream
+// of the current thread instead of std::cerr
+class DiagErrorListener : public antlr4::BaseErrorListener {
+public:
+    static DiagErrorListener INSTANCE;
+
+    virtual void syntaxError(antlr4::Recognizer *recognizer,
+                             antlr4::Token *offendingSymbol, size_t line,
+                             size_t charPositionInLine, const std::string &msg,
+                             std::exception_ptr e) override;
+};
+
+// Holds the errors back until it is known whether they should be printed:
+// errors of a parser that runs along with the lexer are dropped if lexing
+// fails, as if parsing never started
+class DeferredErrorListener : public antlr4::BaseErrorListener {
+public:
+    virtual void syntaxError(antlr4::Recognizer *recognizer,
+                             antlr4::Token *offendingSymbol, size_t line,
+                             size_t charPositionInLine, const std::string &msg,
+                             std::exception_ptr e) override;
+
+    // Print the errors held so far to the diagnostic stream
+    void flush();
+
+private:
+    std::ostringstream errors;
+};
+
+#endif
@@ -0,0 +1,162 @@
+#include "Utf8CharStream.h"
+
+#include <cstring>
+
+using namespace antlr4;
+
+Utf8CharStream::Utf8CharStream(const char *data, size_t size,
+                               const std::string &name)
+    : data(reinterpret_cast<const unsigned char *>(data)), length(size),
+      name(name) {
+    // Like ANTLRInputStream, skip the byte order mark
+    if (size >= 3 && std::memcmp(data, "\xEF\xBB\xBF", 3) == 0) {
+        this->data += 3;
+        length -= 3;
+    }
+}
+
+const char *Utf8CharStream::getData() const {
+    return reinterpret_cast<const char *>(data);
+}
+
+static bool isContinuation(unsigned char c) { return (c & 0xC0) == 0x80; }
+
+// Malformed sequences decode byte by byte, each byte as its own value
+size_t Utf8CharStream::decode(size_t pos, size_t *len) const {
+    unsigned char c = data[pos];
+    size_t n;
+    size_t cp;
+
+    *len = 1;
+    if (c < 0x80) {
+        return c;
+    } else if (c >= 0xC2 && c <= 0xDF) {
+        n = 2;
+        cp = c & 0x1F;
+    } else if (c >= 0xE0 && c <= 0xEF) {
+        n = 3;
+        cp = c & 0x0F;
+    } else if (c >= 0xF0 && c <= 0xF4) {
+        n = 4;
+        cp = c & 0x07;
+    } else {
+        return c;
+    }
+
+    if (pos + n > length) {
+        return c;
+    }
+    for (size_t i = 1; i < n; i++) {
+        if (!isContinuation(data[pos + i])) {
+            return c;
+        }
+        cp = (cp << 6) | (data[pos + i] & 0x3F);
+    }
+    // overlong forms, surrogates and values past U+10FFFF
+    if ((n == 3 && cp < 0x800) || (n == 4 && cp < 0x10000) ||
+        (cp >= 0xD800 && cp <= 0xDFFF) || cp > 0x10FFFF) {
+        return c;
+    }
+
+    *len = n;
+    return cp;
+}
+
+size_t Utf8CharStream::nextPos(size_t pos) const {
+    size_t len;
+    decode(pos, &len);
+    return pos + len;
+}
+
+size_t Utf8CharStream::prevPos(size_t pos) const {
+    size_t start = pos - 1;
+    while (start > 0 && pos - start < 4 && isContinuation(data[start])) {
+        start--;
+    }
+
+    size_t len;
+    decode(start, &len);
+    return start + len == pos ? start : pos - 1;
+}
+
+void Utf8CharStream::consume() {
+    if (p >= length) {
+        throw IllegalStateException("cannot consume EOF");
+    }
+    p = nextPos(p);
+}
+
+size_t Utf8CharStream::LA(ssize_t i) {
+    size_t q = p;
+    size_t len;
+
+    if (i == 0) {
+        return 0;
+    }
+    if (i < 0) {
+        for (; i < 0; i++) {
+            if (q == 0) {
+                return EOF;
+            }
+            q = prevPos(q);
+        }
+        return decode(q, &len);
+    }
+
+    for (; i > 1; i--) {
+        if (q >= length) {
+            return EOF;
+        }
+        q = nextPos(q);
+    }
+    if (q >= length) {
+        return EOF;
+    }
+    return decode(q, &len);
+}
+
+ssize_t Utf8CharStream::mark() { return -1; }
+
+void Utf8CharStream::release(ssize_t marker) {}
+
+size_t Utf8CharStream::index() { return p; }
+
+// The lexer only seeks to indexes it got from index(), which are always
+// code point boundaries
+void Utf8CharStream::seek(size_t index) { p = std::min(index, length); }
+
+size_t Utf8CharStream::size() { return length; }
+
+std::string Utf8CharStream::getSourceName() const {
+    if (name.empty()) {
+        return IntStream::UNKNOWN_SOURCE_NAME;
+    }
+    return name;
+}
+
+std::string Utf8CharStream::getText(const misc::Interval &interval) {
+    if (interval.a < 0 || interval.b < 0) {
+        return "";
+    }
+
+    size_t start = interval.a;
+    size_t stop = interval.b;
+    if (start >= length) {
+        return "";
+    }
+    if (stop >= length) {
+        stop = length - 1;
+    }
+    while (stop + 1 < length && isContinuation(data[stop + 1])) {
+        stop++;
+    }
+    if (start > stop) {
+        return "";
+    }
+    return std::string(reinterpret_cast<const char *>(data + start),
+                       stop - start + 1);
+}
+
+std::string Utf8CharStream::toString() const {
+    return std::string(reinterpret_cast<const char *>(data), length);
+}
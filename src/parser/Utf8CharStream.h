@@ -0,0 +1,45 @@
+#ifndef _UTF8_CHAR_STREAM_H_
+#define _UTF8_CHAR_STREAM_H_
+
+#include <string>
+
+#include "antlr4-runtime.h"
+
+// A char stream over UTF-8 text owned by someone else (usually a mapped
+// source file). Unlike antlr4::ANTLRInputStream it doesn't decode the text
+// into a UTF-32 copy: code points are decoded as the lexer reads them and
+// stream indexes, hence token start/stop indexes, are byte offsets.
+class Utf8CharStream : public antlr4::CharStream {
+public:
+    Utf8CharStream(const char *data, size_t size, const std::string &name);
+
+    virtual void consume() override;
+    virtual size_t LA(ssize_t i) override;
+    virtual ssize_t mark() override;
+    virtual void release(ssize_t marker) override;
+    virtual size_t index() override;
+    virtual void seek(size_t index) override;
+    virtual size_t size() override;
+    virtual std::string getSourceName() const override;
+
+    // Texts run to the end of the code point starting at interval.b
+    virtual std::string getText(const antlr4::misc::Interval &interval) override;
+    virtual std::string toString() const override;
+
+    // The text, for scanners that read it directly; indexes are offsets
+    const char *getData() const;
+    // Code point at byte offset pos, its encoded length goes to len
+    size_t decode(size_t pos, size_t *len) const;
+
+private:
+    const unsigned char *data;
+    size_t length;
+    std::string name;
+    // byte offset of the next code point
+    size_t p = 0;
+
+    size_t nextPos(size_t pos) const;
+    size_t prevPos(size_t pos) const;
+};
+
+#endif
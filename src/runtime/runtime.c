@@ -2,6 +2,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include "runtime.h"
 
 // DECAF Standard Library
 
@@ -10,15 +11,6 @@
 #define INT_MAX_LENGHT 12
 #define INT_MAX_LENGHT_STR "12"
 
-void* _dcf_ALLOCATE(size_t size);
-char* _dcf_READ_LINE();
-int32_t _dcf_READ_INT();
-int32_t _dcf_STRING_EQUAL(const char *s1, const char *s2);
-void _dcf_PRINT_INT(int32_t i);
-void _dcf_PRINT_STRING(const char *s);
-void _dcf_PRINT_BOOL(int32_t b);
-void _dcf_HALT(const char *msg);
-
 void* _dcf_ALLOCATE(size_t size) {
     void *p = calloc(size, 1);
     if (!p) {
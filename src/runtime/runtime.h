@@ -0,0 +1,25 @@
+#ifndef _DECAF_RUNTIME_H_
+#define _DECAF_RUNTIME_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void* _dcf_ALLOCATE(size_t size);
+char* _dcf_READ_LINE();
+int32_t _dcf_READ_INT();
+int32_t _dcf_STRING_EQUAL(const char *s1, const char *s2);
+void _dcf_PRINT_INT(int32_t i);
+void _dcf_PRINT_STRING(const char *s);
+void _dcf_PRINT_BOOL(int32_t b);
+void _dcf_HALT(const char *msg);
+int32_t _dcf_rt_INSTANCE_OF(void *vptr, const void *dstVtbl);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -2,9 +2,11 @@
 #define _SCOPE_H_
 
 #include "Pos.h"
+#include "ast/Name.h"
 #include "Symbol.h"
 #include "antlr4-runtime.h"
 #include <memory>
+#include <ostream>
 
 class Symbol;
 class SymbolHash;
@@ -14,7 +16,7 @@ public:
     enum Kind { GLOBAL, CLASS, FORMAL, LOCAL };
 
     Pos pos;
-    std::string name;
+    Name name;
     Kind kind;
 
     virtual ~Scope();
@@ -23,20 +25,16 @@ public:
     void setSymbol(std::shared_ptr<Symbol> s);
 
     void setParent(const std::shared_ptr<Scope> &p);
-    virtual std::shared_ptr<Symbol> lookup(const std::string &name);
-    virtual std::shared_ptr<Symbol> lookupBefore(const Pos &pos,
-                                                 const std::string &name);
-    virtual bool declare(const std::string &name,
-                         std::shared_ptr<Symbol> symbol);
+    virtual std::shared_ptr<Symbol> lookup(Name name);
+    virtual std::shared_ptr<Symbol> lookupBefore(const Pos &pos, Name name);
+    virtual bool declare(Name name, std::shared_ptr<Symbol> symbol);
 
-    virtual std::shared_ptr<Scope> createScope(const Pos &p,
-                                               const std::string &name);
+    virtual std::shared_ptr<Scope> createScope(const Pos &p, Name name);
 
-    virtual void print(int level) = 0;
+    virtual void print(std::ostream &os, int level) = 0;
 
     std::vector<std::shared_ptr<Symbol>> getOrderedSymbols();
 
-    std::shared_ptr<Scope> enterScope(const Pos &p);
     std::shared_ptr<Scope> exitScope();
 
 protected:
@@ -46,12 +44,13 @@ protected:
     std::weak_ptr<Symbol> selfSymbol;
 
     // symbols inside this scope
-    std::unordered_map<std::string, std::shared_ptr<Symbol>> symbols;
-    // sub-scopes inside this scope
-    std::unordered_map<Pos, std::shared_ptr<Scope>, PosHash> scopes;
+    std::unordered_map<Name, std::shared_ptr<Symbol>, Name::Hash> symbols;
+    // sub-scopes inside this scope, in creation order. The passes reach
+    // them through the nodes that open them, see ASTAttrManager::getScope
+    std::vector<std::shared_ptr<Scope>> scopes;
 
-    std::shared_ptr<Symbol> lookupThis(const std::string &name);
-    std::shared_ptr<Symbol> lookupParent(const std::string &name);
+    std::shared_ptr<Symbol> lookupThis(Name name);
+    std::shared_ptr<Symbol> lookupParent(Name name);
     std::string printIdent(int level);
 
     std::vector<std::shared_ptr<Scope>> getOrderedScopes();
@@ -5,6 +5,7 @@
 #include <memory>
 #include <unordered_map>
 #include "Pos.h"
+#include "ast/Name.h"
 #include "Scope.h"
 #include "Type.h"
 
@@ -25,8 +26,11 @@ public:
     };
 
     Pos pos;
-    std::string name;
+    Name name;
     std::shared_ptr<Type> type;
+    // unique among the symbols of one program, ASTAttrManager keeps the
+    // LLVM value of a variable (symLLVMVals) at this index
+    unsigned id = 0;
     
     ~Symbol();
     Symbol::Kind getKind() const;
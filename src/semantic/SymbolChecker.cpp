@@ -7,20 +7,24 @@
 #include "MethodSymbol.h"
 #include "Pos.h"
 #include "VarSymbol.h"
-#include "parser/antlr/DecafParserParser.h"
 #include "utils/printer.h"
 #include <cassert>
 
 using namespace std;
 
-SymbolChecker::SymbolChecker(antlr4::tree::ParseTree *ast) {
+SymbolChecker::SymbolChecker(TopLevel *ast, CompileContext &cc)
+    : names(cc.ast) {
     this->ast = ast;
+    baseChecker = &cc.baseChecker;
+    types = &cc.types;
+    attrManager = cc.attrManager;
+    attrManager->resizeNodeTables(cc.ast.getNumNodes());
     globalScope = std::make_shared<GlobalScope>();
     cur = globalScope;
 }
 
 std::shared_ptr<Scope> SymbolChecker::buildTable() {
-    visit(ast);
+    visitTopLevel(ast);
     if (symbolFailed) {
         return nullptr;
     } else {
@@ -28,220 +32,190 @@ std::shared_ptr<Scope> SymbolChecker::buildTable() {
     }
 }
 
-antlrcpp::Any
-SymbolChecker::visitTopLevel(DecafParserParser::TopLevelContext *ctx) {
+void SymbolChecker::visitTopLevel(TopLevel *node) {
     // Check Definitions for Class
     phase = Phase::CHECK_CLASS;
-    visitChildren(ctx); // add classes, no duplication
+    ASTVisitor::visitTopLevel(node); // add classes, no duplication
 
     // check base-class, remove cyclic inheritance
     phase = Phase::CHECK_BASE;
-    visitChildren(ctx);
+    ASTVisitor::visitTopLevel(node);
     if (symbolFailed) {
-        return nullptr;
+        return;
+    }
+
+    // the hierarchy is final now, number it for the subtype tests
+    std::vector<Name> classes;
+    for (ClassDef *c : node->classes) {
+        classes.push_back(c->name);
     }
+    baseChecker->buildTable(classes);
 
     // Check Definitions for Methods
     phase = Phase::CHECK_MEMBER;
-    visitChildren(ctx);
+    ASTVisitor::visitTopLevel(node);
 
     // should be a 'Main' class contains main method 'static void main()'
     if (!checkMain()) {
         symbolFailed = true;
         reportErrorText(CompileErrors::NO_LEGAL_MAIN, {});
     }
-
-    return nullptr;
 }
 
-antlrcpp::Any
-SymbolChecker::visitClassDef(DecafParserParser::ClassDefContext *ctx) {
+void SymbolChecker::visitClassDef(ClassDef *node) {
     if (phase == Phase::CHECK_CLASS) {
-        return addClasses(ctx);
+        addClasses(node);
     } else if (phase == Phase::CHECK_BASE) {
-        return checkBase(ctx);
+        checkBase(node);
     } else if (phase == Phase::CHECK_MEMBER) {
-        Pos pos = getClassPos(ctx);
-        auto p = cur->enterScope(pos);
+        auto p = attrManager->getScope(node);
         if (p) {
             cur = p;
-            visitChildren(ctx);
+            ASTVisitor::visitClassDef(node);
             cur = cur->exitScope();
         }
     }
-    return nullptr;
 }
 
-antlrcpp::Any
-SymbolChecker::visitVarDef(DecafParserParser::VarDefContext *ctx) {
+void SymbolChecker::visitVarDef(VarDef *node) {
     if (phase == Phase::CHECK_MEMBER) {
-        antlr4::Token *idTok = ctx->var()->id()->IDENTIFIER()->getSymbol();
-        std::string id = idTok->getText();
-        Pos pos = getVarPos(ctx->var());
-
         std::shared_ptr<Symbol> symbol = std::make_shared<VarSymbol>();
-        symbol->pos = pos;
-        symbol->name = id;
-        symbol->type = getType(ctx->var()->type());
-        if (!cur->declare(id, symbol)) {
+        symbol->id = numSymbols++;
+        symbol->pos = node->pos;
+        symbol->name = node->name;
+        symbol->type = getType(node->type);
+        if (!cur->declare(symbol->name, symbol)) {
             symbolFailed = true;
-            return nullptr;
+            return;
         }
     }
-    return nullptr;
 }
 
-antlrcpp::Any
-SymbolChecker::visitMethodDef(DecafParserParser::MethodDefContext *ctx) {
+void SymbolChecker::visitMethodDef(MethodDef *node) {
     if (phase == Phase::CHECK_MEMBER) {
-        antlr4::Token *idTok = ctx->id()->IDENTIFIER()->getSymbol();
-        std::string id = idTok->getText();
-        bool isStatic = ctx->STATIC() != nullptr;
-        Pos pos = getMethodPos(ctx);
+        Name id = node->name;
+        Pos pos = node->pos;
 
         std::shared_ptr<Symbol> symbol = std::make_shared<MethodSymbol>();
+        symbol->id = numSymbols++;
         symbol->pos = pos;
         symbol->name = id;
-        symbol->setStatic(isStatic);
-        symbol->type = getMethodType(ctx);
+        symbol->setStatic(node->isStatic);
+        symbol->type = getMethodType(node);
 
         if (!cur->declare(id, symbol)) {
             symbolFailed = true;
         }
 
-        cur->createScope(pos, id);
-        cur = cur->enterScope(pos);
+        cur = cur->createScope(pos, id);
+        attrManager->setScope(node, cur);
 
         cur->setSymbol(symbol);
         symbol->setScope(cur);
 
-        visitVarList(ctx->varList()); // parameters
-        visitBlock(ctx->block());     // method block
+        declareParams(node);   // parameters
+        visitBlock(node->body); // method block
         cur = cur->exitScope();
     }
-    return nullptr;
 }
 
-antlrcpp::Any
-SymbolChecker::visitVarList(DecafParserParser::VarListContext *ctx) {
-    if (phase == Phase::CHECK_MEMBER) {
-        auto paras = ctx->paraVarDef();
-        std::vector<std::shared_ptr<Type>> parasType;
-
-        if (!cur->getSymbol()->isStatic()) {
-            std::shared_ptr<Symbol> classSym = cur->getParent()->getSymbol();
-            std::shared_ptr<Symbol> varSym = std::make_shared<VarSymbol>();
-
-            varSym->pos = cur->pos;
-            varSym->name = "this";
-            varSym->type = classSym->type;
-            if (!cur->declare(varSym->name, varSym)) {
-                symbolFailed = true;
-            }
-        }
+void SymbolChecker::declareParams(MethodDef *node) {
+    if (!cur->getSymbol()->isStatic()) {
+        std::shared_ptr<Symbol> classSym = cur->getParent()->getSymbol();
+        std::shared_ptr<Symbol> varSym = std::make_shared<VarSymbol>();
+        varSym->id = numSymbols++;
 
-        for (std::size_t i = 0; i < paras.size(); i++) {
-            DecafParserParser::VarContext *varCtx = paras[i]->var();
-            std::shared_ptr<Type> ptype = getType(varCtx->type());
-            antlr4::Token *idTok = varCtx->id()->IDENTIFIER()->getSymbol();
-            Pos pos = getVarPos(varCtx);
+        varSym->pos = cur->pos;
+        varSym->name = names.intern("this");
+        varSym->type = classSym->type;
+        if (!cur->declare(varSym->name, varSym)) {
+            symbolFailed = true;
+        }
+    }
 
-            std::shared_ptr<Symbol> varSym = std::make_shared<VarSymbol>();
-            varSym->pos = pos;
-            varSym->name = idTok->getText();
-            varSym->type = ptype;
+    for (VarDef *param : node->params) {
+        std::shared_ptr<Symbol> varSym = std::make_shared<VarSymbol>();
+        varSym->id = numSymbols++;
+        varSym->pos = param->pos;
+        varSym->name = param->name;
+        varSym->type = getType(param->type);
 
-            if (!cur->declare(varSym->name, varSym)) {
-                symbolFailed = true;
-            }
+        if (!cur->declare(varSym->name, varSym)) {
+            symbolFailed = true;
         }
     }
-    return nullptr;
 }
 
-antlrcpp::Any
-SymbolChecker::visitForStmt(DecafParserParser::ForStmtContext *ctx) {
-    Pos pos = getForPos(ctx);
-
-    cur = cur->createScope(pos, "");
-    visitChildren(ctx);
+void SymbolChecker::visitForStmt(ForStmt *node) {
+    cur = cur->createScope(node->pos, Name());
+    attrManager->setScope(node, cur);
+    ASTVisitor::visitForStmt(node);
     cur = cur->exitScope();
-    return nullptr;
 }
 
-antlrcpp::Any SymbolChecker::visitBlock(DecafParserParser::BlockContext *ctx) {
-    Pos pos = getBlockPos(ctx);
-
-    cur = cur->createScope(pos, "");
-    visitChildren(ctx);
+void SymbolChecker::visitBlock(Block *node) {
+    cur = cur->createScope(node->pos, Name());
+    attrManager->setScope(node, cur);
+    ASTVisitor::visitBlock(node);
     cur = cur->exitScope();
-    return nullptr;
 }
 
-antlrcpp::Any
-SymbolChecker::visitLocalVarDef(DecafParserParser::LocalVarDefContext *ctx) {
+void SymbolChecker::visitLocalVarDef(LocalVarDef *node) {
     if (phase == Phase::CHECK_MEMBER) {
-        antlr4::Token *idTok = ctx->var()->id()->IDENTIFIER()->getSymbol();
-        std::string id = idTok->getText();
-        Pos pos = getVarPos(ctx->var());
-
         std::shared_ptr<Symbol> varSym = std::make_shared<VarSymbol>();
-        varSym->pos = pos;
-        varSym->name = id;
-        varSym->type = getType(ctx->var()->type());
+        varSym->id = numSymbols++;
+        varSym->pos = node->var->pos;
+        varSym->name = node->var->name;
+        varSym->type = getType(node->var->type);
         if (!cur->declare(varSym->name, varSym)) {
             symbolFailed = true;
-            return nullptr;
         }
     }
-    return visitChildren(ctx);
 }
 
-antlrcpp::Any
-SymbolChecker::addClasses(DecafParserParser::ClassDefContext *ctx) {
-    Pos pos = getClassPos(ctx);
+void SymbolChecker::addClasses(ClassDef *node) {
+    Pos pos = node->pos;
 
-    std::shared_ptr<Symbol> symbol = std::make_shared<ClassSymbol>();
+    std::shared_ptr<Symbol> symbol = std::make_shared<ClassSymbol>(baseChecker);
+    symbol->id = numSymbols++;
     symbol->pos = pos;
-    symbol->name = ctx->id()->getText();
-    symbol->type = std::make_shared<ClassType>(symbol->name);
+    symbol->name = node->name;
+    symbol->type = types->getClass(symbol->name);
 
     bool succ = cur->declare(symbol->name, symbol);
     if (!succ) {
         symbolFailed = true;
-        return nullptr;
+        return;
     }
 
     std::shared_ptr<Scope> newclass = cur->createScope(pos, symbol->name);
 
+    attrManager->setScope(node, newclass);
     newclass->setSymbol(symbol);
     symbol->setScope(newclass);
 
     // set baseclass
-    if (ctx->extendClause()) {
-        std::string baseName = ctx->extendClause()->id()->getText();
-        BaseChecker::setBase(symbol->name, baseName);
+    if (!node->baseName.empty()) {
+        baseChecker->setBase(symbol->name, node->baseName);
     }
-    return nullptr;
 }
 
-antlrcpp::Any
-SymbolChecker::checkBase(DecafParserParser::ClassDefContext *ctx) {
-    if (!ctx->extendClause()) {
-        return nullptr;
+void SymbolChecker::checkBase(ClassDef *node) {
+    if (node->baseName.empty()) {
+        return;
     }
-    Pos pos = getClassPos(ctx);
-    std::string curName = ctx->id()->getText();
+    Pos pos = node->pos;
+    Name curName = node->name;
     std::shared_ptr<Symbol> curSymbol = cur->lookup(curName);
 
     // baseclass not defined
-    std::string baseName = ctx->extendClause()->id()->getText();
+    Name baseName = node->baseName;
     std::shared_ptr<Symbol> baseSymbol = cur->lookup(baseName);
     if (baseSymbol == nullptr) {
-        vector<string> texts = {baseName};
+        vector<string> texts = {baseName.str()};
         reportErrorText(pos, CompileErrors::CLASS_NOT_FOUND, texts);
         symbolFailed = true;
-        return nullptr;
+        return;
     }
 
     // detect cyclic inheritance
@@ -251,12 +225,12 @@ SymbolChecker::checkBase(DecafParserParser::ClassDefContext *ctx) {
             reportErrorText(pos, CompileErrors::CYCLIC_INHERITANCE, {});
 
             // cut off the relation for no duplicated errors
-            BaseChecker::setBase(ptr->name, "");
+            baseChecker->setBase(ptr->name, Name());
             symbolFailed = true;
-            return nullptr;
+            return;
         }
 
-        ptr = cur->lookup(BaseChecker::getBase(ptr->name));
+        ptr = cur->lookup(baseChecker->getBase(ptr->name));
         if (!ptr) {
             // base not defined. But leave it
             break;
@@ -267,67 +241,61 @@ SymbolChecker::checkBase(DecafParserParser::ClassDefContext *ctx) {
     // std::shared_ptr<Scope> baseScope = cur->enterScope(baseSymbol->pos);
     // std::shared_ptr<Scope> curScope = cur->enterScope(curSymbol->pos);
     // curScope->setParent(baseScope);
-
-    return nullptr;
 }
 
 // get Built-in or Array type
-std::shared_ptr<Type>
-SymbolChecker::getType(DecafParserParser::TypeContext *ctx) {
-    if (ctx->INT()) {
-        return std::make_shared<BuiltInType>(Type::INTEGER_TYPE);
-    } else if (ctx->BOOL()) {
-        return std::make_shared<BuiltInType>(Type::BOOL_TYPE);
-    } else if (ctx->STRING()) {
-        return std::make_shared<BuiltInType>(Type::STRING_TYPE);
-    } else if (ctx->VOID()) {
-        return std::make_shared<BuiltInType>(Type::VOID_TYPE);
-    } else if (ctx->classType()) {
-        return std::make_shared<ClassType>(ctx->classType()->id()->getText());
-    } else if (ctx->LBRACKET()) {
-        if (ctx->type()->VOID()) {
-            Pos pos = getTokenPos(ctx->type()->VOID()->getSymbol());
-            reportErrorText(pos, CompileErrors::VOID_ARRAY, {});
+std::shared_ptr<Type> SymbolChecker::getType(TypeLit *node) {
+    switch (node->base) {
+    case TypeLit::INT:
+        return types->getBuiltIn(Type::INTEGER_TYPE);
+    case TypeLit::BOOL:
+        return types->getBuiltIn(Type::BOOL_TYPE);
+    case TypeLit::STRING:
+        return types->getBuiltIn(Type::STRING_TYPE);
+    case TypeLit::VOID:
+        return types->getBuiltIn(Type::VOID_TYPE);
+    case TypeLit::CLASS:
+        return types->getClass(node->className);
+    case TypeLit::ARRAY:
+        if (node->elem->base == TypeLit::VOID) {
+            reportErrorText(node->elem->pos, CompileErrors::VOID_ARRAY, {});
             symbolFailed = true;
         }
-        return std::make_shared<ArrayType>(getType(ctx->type()));
+        return types->getArray(getType(node->elem));
     }
     return nullptr;
 }
 
-std::shared_ptr<MethodType>
-SymbolChecker::getMethodType(DecafParserParser::MethodDefContext *ctx) {
-    std::shared_ptr<Type> retType = getType(ctx->type());
-    auto paras = ctx->varList()->paraVarDef();
+std::shared_ptr<MethodType> SymbolChecker::getMethodType(MethodDef *node) {
+    std::shared_ptr<Type> retType = getType(node->retType);
     std::vector<std::shared_ptr<Type>> parasType;
 
     // add each parameter to scope
-    for (std::size_t i = 0; i < paras.size(); i++) {
-        DecafParserParser::VarContext *varCtx = paras[i]->var();
-        std::shared_ptr<Type> ptype = getType(varCtx->type());
-        antlr4::Token *idTok = varCtx->id()->IDENTIFIER()->getSymbol();
-        Pos pos = getMethodPos(ctx);
+    for (VarDef *param : node->params) {
+        std::shared_ptr<Type> ptype = getType(param->type);
 
         // no VOID parameter
         if (ptype->getKind() == Type::VOID_TYPE) {
-            reportErrorText(pos, CompileErrors::VOID_IDENTIFIER,
-                            {idTok->getText()});
+            reportErrorText(node->pos, CompileErrors::VOID_IDENTIFIER,
+                            {param->name.str()});
             symbolFailed = true;
             continue;
         }
         parasType.push_back(ptype);
     }
 
-    return std::make_shared<MethodType>(retType, parasType);
+    return types->getMethod(retType, parasType);
 }
 
 bool SymbolChecker::checkMain() {
-    std::shared_ptr<Symbol> classSym = globalScope->lookup("Main");
+    std::shared_ptr<Symbol> classSym =
+        globalScope->lookup(names.intern("Main"));
     if (!classSym) {
         return false;
     }
 
-    std::shared_ptr<Symbol> methodSym = classSym->getScope()->lookup("main");
+    std::shared_ptr<Symbol> methodSym =
+        classSym->getScope()->lookup(names.intern("main"));
     if (!methodSym || methodSym->getKind() != Symbol::METHOD ||
         !methodSym->isStatic()) {
         return false;
@@ -2,55 +2,51 @@
 #define _SYMBOL_CHECKER_H_
 
 #include "Scope.h"
-#include "parser/antlr/DecafParserBaseVisitor.h"
+#include "ast/ASTVisitor.h"
+#include "utils/CompileContext.h"
 
-class SymbolChecker : public DecafParserBaseVisitor {
+class SymbolChecker : public ASTVisitor<SymbolChecker> {
 public:
     enum class Phase { CHECK_CLASS, CHECK_BASE, CHECK_MEMBER };
 
     Phase phase = Phase::CHECK_CLASS;
 
-    SymbolChecker(antlr4::tree::ParseTree *ast);
+    SymbolChecker(TopLevel *ast, CompileContext &cc);
 
     std::shared_ptr<Scope> buildTable();
 
-    virtual antlrcpp::Any
-    visitTopLevel(DecafParserParser::TopLevelContext *ctx) override;
+    void visitTopLevel(TopLevel *node);
 
-    virtual antlrcpp::Any
-    visitClassDef(DecafParserParser::ClassDefContext *ctx) override;
+    void visitClassDef(ClassDef *node);
 
-    virtual antlrcpp::Any
-    visitVarDef(DecafParserParser::VarDefContext *ctx) override;
+    void visitVarDef(VarDef *node);
 
-    virtual antlrcpp::Any
-    visitMethodDef(DecafParserParser::MethodDefContext *ctx) override;
+    void visitMethodDef(MethodDef *node);
 
-    virtual antlrcpp::Any
-    visitVarList(DecafParserParser::VarListContext *ctx) override;
+    void visitForStmt(ForStmt *node);
 
-    virtual antlrcpp::Any
-    visitForStmt(DecafParserParser::ForStmtContext *ctx) override;
+    void visitBlock(Block *node);
 
-    virtual antlrcpp::Any
-    visitBlock(DecafParserParser::BlockContext *ctx) override;
-
-    virtual antlrcpp::Any visitLocalVarDef(
-        DecafParserParser::LocalVarDefContext *ctx) override;
+    void visitLocalVarDef(LocalVarDef *node);
 
 private:
     std::shared_ptr<Scope> cur;
     std::shared_ptr<Scope> globalScope;
-    antlr4::tree::ParseTree *ast;
+    TopLevel *ast;
+    BaseChecker *baseChecker;
+    std::shared_ptr<ASTAttrManager> attrManager;
+    TypeFactory *types;
+    ASTContext &names;
     bool symbolFailed = false;
+    unsigned numSymbols = 0;
 
-    antlrcpp::Any addClasses(DecafParserParser::ClassDefContext *ctx);
-    antlrcpp::Any checkBase(DecafParserParser::ClassDefContext *ctx);
-    std::shared_ptr<Type> getType(DecafParserParser::TypeContext *ctx);
+    void addClasses(ClassDef *node);
+    void checkBase(ClassDef *node);
+    void declareParams(MethodDef *node);
+    std::shared_ptr<Type> getType(TypeLit *node);
 
-    std::shared_ptr<MethodType>
-    getMethodType(DecafParserParser::MethodDefContext *ctx);
+    std::shared_ptr<MethodType> getMethodType(MethodDef *node);
 
     bool checkMain();
 };
-#endif
\ No newline at end of file
+#endif
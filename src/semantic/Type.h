@@ -1,6 +1,8 @@
 #ifndef _DECAF_TYPE_H_
 #define _DECAF_TYPE_H_
 
+#include "ast/Name.h"
+#include "semantic/type/BaseChecker.h"
 #include <memory>
 #include <string>
 #include <vector>
@@ -38,15 +40,22 @@ public:
     virtual std::string toString() const override;
 };
 
+// Canonical class types come from the TypeFactory, so a class type is only
+// the same as itself. Subtype tests compare the classes' ranges in the
+// hierarchy table, which must be built before the first comparison
 class ClassType : public Type {
 public:
-    ClassType(const std::string &name);
+    ClassType(Name name, const BaseChecker *bc);
     virtual Type::Relation compare(const std::shared_ptr<Type> other) const override;
     virtual std::string toString() const override;
-    std::string getName() const;
+    Name getName() const;
 
 private:
-    std::string name;
+    Name name;
+    const BaseChecker *baseChecker;
+    mutable const ClassRange *range = nullptr;
+
+    const ClassRange &getRange() const;
 };
 
 class MethodType : public Type {
@@ -3,641 +3,400 @@
 #include "BaseChecker.h"
 #include "Pos.h"
 
-TypeChecker::TypeChecker(antlr4::tree::ParseTree *ast,
-                         std::shared_ptr<Scope> global,
-                         std::shared_ptr<ASTAttrManager> am) {
+TypeChecker::TypeChecker(TopLevel *ast, CompileContext &cc) {
     this->ast = ast;
-    this->global = global;
+    global = cc.globalScope;
     cur = global;
-    attrManager = am;
+    attrManager = cc.attrManager;
+    baseChecker = &cc.baseChecker;
+    types = &cc.types;
 }
 
 bool TypeChecker::check() {
-    visit(ast);
+    visitTopLevel(ast);
     return !typeFailed;
 }
 
-antlrcpp::Any
-TypeChecker::visitClassDef(DecafParserParser::ClassDefContext *ctx) {
-    Pos pos = getClassPos(ctx);
-    std::shared_ptr<Scope> classScope = cur->enterScope(pos);
+void TypeChecker::visitClassDef(ClassDef *node) {
+    std::shared_ptr<Scope> classScope = attrManager->getScope(node);
 
     if (classScope) {
         cur = classScope;
         curClass = classScope->getSymbol();
-        for (auto &x : ctx->field()) {
-            visit(x);
+        for (ASTNode *x : node->fields) {
+            visitField(x);
         }
         cur = cur->exitScope();
         curClass = nullptr;
     }
-    return nullptr;
 }
 
-antlrcpp::Any
-TypeChecker::visitMethodDef(DecafParserParser::MethodDefContext *ctx) {
-    Pos pos = getMethodPos(ctx);
-
-    cur = cur->enterScope(pos);
+void TypeChecker::visitMethodDef(MethodDef *node) {
+    cur = attrManager->getScope(node);
     curMethod = cur->getSymbol();
-    visit(ctx->block());
+    visitBlock(node->body);
     cur = cur->exitScope();
 
     // detect missing return
     std::shared_ptr<Type> retType =
         std::dynamic_pointer_cast<MethodType>(curMethod->type)->getRetType();
-    if (retType->getKind() != Type::VOID_TYPE && !attrManager->getHasRet(ctx->block())) {
-        Pos pos = getBlockPos(ctx->block());
-        fail(pos, CompileErrors::MISSING_RETURN, {});
+    if (retType->getKind() != Type::VOID_TYPE &&
+        !attrManager->getHasRet(node->body)) {
+        fail(node->body->pos, CompileErrors::MISSING_RETURN, {});
     }
 
     curMethod = nullptr;
-    return nullptr;
 }
 
-antlrcpp::Any TypeChecker::visitType(DecafParserParser::TypeContext *ctx) {
+std::shared_ptr<Type> TypeChecker::getType(TypeLit *node) {
     std::shared_ptr<Type> ret;
 
-    if (ctx->INT()) {
-        ret = std::make_shared<BuiltInType>(Type::INTEGER_TYPE);
-    } else if (ctx->BOOL()) {
-        ret = std::make_shared<BuiltInType>(Type::BOOL_TYPE);
-    } else if (ctx->STRING()) {
-        ret = std::make_shared<BuiltInType>(Type::STRING_TYPE);
-    } else if (ctx->VOID()) {
-        ret = std::make_shared<BuiltInType>(Type::VOID_TYPE);
-    } else if (ctx->classType()) {
-        ret = std::make_shared<ClassType>(ctx->classType()->id()->getText());
-    } else if (ctx->LBRACKET()) {
-        if (ctx->type()->VOID()) {
-            Pos pos = getTokenPos(ctx->type()->VOID()->getSymbol());
-            fail(pos, CompileErrors::VOID_ARRAY, {});
-            ret = std::make_shared<ErrorType>();
+    switch (node->base) {
+    case TypeLit::INT:
+        ret = types->getBuiltIn(Type::INTEGER_TYPE);
+        break;
+    case TypeLit::BOOL:
+        ret = types->getBuiltIn(Type::BOOL_TYPE);
+        break;
+    case TypeLit::STRING:
+        ret = types->getBuiltIn(Type::STRING_TYPE);
+        break;
+    case TypeLit::VOID:
+        ret = types->getBuiltIn(Type::VOID_TYPE);
+        break;
+    case TypeLit::CLASS:
+        ret = types->getClass(node->className);
+        break;
+    case TypeLit::ARRAY:
+        if (node->elem->base == TypeLit::VOID) {
+            fail(node->elem->pos, CompileErrors::VOID_ARRAY, {});
+            ret = types->getError();
         } else {
-            std::shared_ptr<Type> bt =
-                visit(ctx->type()).as<std::shared_ptr<Type>>();
-            ret = std::make_shared<ArrayType>(bt);
+            ret = types->getArray(getType(node->elem));
         }
+        break;
     }
 
     return ret;
 }
 
-antlrcpp::Any
-TypeChecker::visitForControl(DecafParserParser::ForControlContext *ctx) {
-    if (ctx->forInit()) {
-        visit(ctx->forInit());
-    }
-
-    std::shared_ptr<Type> testT = visit(ctx->expr());
-    if (testT->getKind() != Type::BOOL_TYPE) {
-        Pos pos = getTokenPos(ctx->expr()->getStart());
-        fail(pos, CompileErrors::TEST_NOT_BOOL, {});
-    }
-
-    if (ctx->forUpdate()) {
-        visit(ctx->forUpdate());
-    }
-    return nullptr;
-}
-
-antlrcpp::Any TypeChecker::visitStmt(DecafParserParser::StmtContext *ctx) {
-    size_t n = ctx->children.size();
-    for (size_t i = 0; i < n; i++) {
-        visit(ctx->children[i]);
-        if (attrManager->getHasRet(ctx->children[i])) {
-            attrManager->setHasRet(ctx, true);
-            break;
-        }
-    }
-    return nullptr;
-}
-
-antlrcpp::Any TypeChecker::visitBlock(DecafParserParser::BlockContext *ctx) {
-    Pos pos = getBlockPos(ctx);
-
-    cur = cur->enterScope(pos);
-    visitChildren(ctx);
+void TypeChecker::visitBlock(Block *node) {
+    cur = attrManager->getScope(node);
+    ASTVisitor::visitBlock(node);
     cur = cur->exitScope();
 
-    size_t n = ctx->blockStmt().size();
-    if (n > 0 && attrManager->getHasRet(ctx->blockStmt(n - 1))) {
-        attrManager->setHasRet(ctx, true);
+    size_t n = node->stmts.size();
+    if (n > 0 && attrManager->getHasRet(node->stmts[n - 1])) {
+        attrManager->setHasRet(node, true);
     }
-    return nullptr;
 }
 
-antlrcpp::Any
-TypeChecker::visitBlockStmt(DecafParserParser::BlockStmtContext *ctx) {
-    size_t n = ctx->children.size();
-    for (size_t i = 0; i < n; i++) {
-        visit(ctx->children[i]);
-        if (attrManager->getHasRet(ctx->children[i])) {
-            attrManager->setHasRet(ctx, true);
-        }
+void TypeChecker::visitLocalVarDef(LocalVarDef *node) {
+    if (!node->init) {
+        return;
     }
-    return nullptr;
-}
 
-antlrcpp::Any
-TypeChecker::visitLocalVarDef(DecafParserParser::LocalVarDefContext *ctx) {
-    if (!ctx->bop) {
-        return nullptr;
-    }
-
-    std::string id = ctx->var()->id()->IDENTIFIER()->getSymbol()->getText();
-    std::shared_ptr<Type> lt = cur->lookup(id)->type;
-    std::shared_ptr<Type> rt = visit(ctx->expr());
+    std::shared_ptr<Type> lt = cur->lookup(node->var->name)->type;
+    std::shared_ptr<Type> rt = visitExpr(node->init);
 
     if (!isCompat(rt, lt)) {
-        Pos pos = getTokenPos(ctx->bop);
-        fail(pos, CompileErrors::INCOMPAT_BIN_OP,
-             {lt->toString(), ctx->bop->getText(), rt->toString()});
+        fail(node->opPos, CompileErrors::INCOMPAT_BIN_OP,
+             {lt->toString(), "=", rt->toString()});
     }
-    return nullptr;
 }
 
-antlrcpp::Any TypeChecker::visitAssign(DecafParserParser::AssignContext *ctx) {
-    std::shared_ptr<Type> lt = visit(ctx->lValue());
-    std::shared_ptr<Type> rt = visit(ctx->expr());
+void TypeChecker::visitAssign(Assign *node) {
+    std::shared_ptr<Type> lt = visitExpr(node->lValue);
+    std::shared_ptr<Type> rt = visitExpr(node->expr);
 
     if (!isCompat(rt, lt)) {
-        Pos pos = getTokenPos(ctx->bop);
-        fail(pos, CompileErrors::INCOMPAT_BIN_OP,
-             {lt->toString(), ctx->bop->getText(), rt->toString()});
+        fail(node->opPos, CompileErrors::INCOMPAT_BIN_OP,
+             {lt->toString(), "=", rt->toString()});
     }
-
-    return nullptr;
 }
 
-antlrcpp::Any TypeChecker::visitIfStmt(DecafParserParser::IfStmtContext *ctx) {
-    std::shared_ptr<Type> testT = visit(ctx->expr());
+void TypeChecker::visitIfStmt(IfStmt *node) {
+    std::shared_ptr<Type> testT = visitExpr(node->cond);
     if (testT->getKind() != Type::BOOL_TYPE) {
-        Pos pos = getTokenPos(ctx->expr()->getStart());
-        fail(pos, CompileErrors::TEST_NOT_BOOL, {});
+        fail(node->cond->pos, CompileErrors::TEST_NOT_BOOL, {});
     }
 
-    visit(ctx->stmt(0));
-    if (ctx->ELSE()) {
-        visit(ctx->stmt(1));
+    visitStmt(node->thenStmt);
+    if (node->elseStmt) {
+        visitStmt(node->elseStmt);
     }
 
-    if (ctx->ELSE() && attrManager->getHasRet(ctx->stmt(0)) &&
-        attrManager->getHasRet(ctx->stmt(1))) {
-        attrManager->setHasRet(ctx, true);
+    if (node->elseStmt && attrManager->getHasRet(node->thenStmt) &&
+        attrManager->getHasRet(node->elseStmt)) {
+        attrManager->setHasRet(node, true);
     }
-
-    return nullptr;
 }
 
-antlrcpp::Any
-TypeChecker::visitWhileStmt(DecafParserParser::WhileStmtContext *ctx) {
+void TypeChecker::visitWhileStmt(WhileStmt *node) {
     loopLevel++;
 
-    std::shared_ptr<Type> testT = visit(ctx->expr());
+    std::shared_ptr<Type> testT = visitExpr(node->cond);
     if (testT->getKind() != Type::BOOL_TYPE) {
-        Pos pos = getTokenPos(ctx->expr()->getStart());
-        fail(pos, CompileErrors::TEST_NOT_BOOL, {});
+        fail(node->cond->pos, CompileErrors::TEST_NOT_BOOL, {});
     }
 
-    visit(ctx->stmt());
+    visitStmt(node->body);
     loopLevel--;
-
-    return nullptr;
 }
 
-antlrcpp::Any
-TypeChecker::visitForStmt(DecafParserParser::ForStmtContext *ctx) {
-    Pos pos = getForPos(ctx);
-
+void TypeChecker::visitForStmt(ForStmt *node) {
     loopLevel++;
-    cur = cur->enterScope(pos);
-    visit(ctx->forControl());
-    visit(ctx->stmt());
+    cur = attrManager->getScope(node);
+
+    if (node->init) {
+        visitStmt(node->init);
+    }
+
+    std::shared_ptr<Type> testT = visitExpr(node->cond);
+    if (testT->getKind() != Type::BOOL_TYPE) {
+        fail(node->cond->pos, CompileErrors::TEST_NOT_BOOL, {});
+    }
+
+    if (node->update) {
+        visitStmt(node->update);
+    }
+
+    visitStmt(node->body);
     cur = cur->exitScope();
     loopLevel--;
-
-    return nullptr;
 }
 
-antlrcpp::Any
-TypeChecker::visitBreakStmt(DecafParserParser::BreakStmtContext *ctx) {
-    Pos pos = getBreakPos(ctx);
+void TypeChecker::visitBreakStmt(BreakStmt *node) {
     if (loopLevel == 0) {
-        fail(pos, CompileErrors::BREAK_OUTSIDE_LOOP, {});
+        fail(node->pos, CompileErrors::BREAK_OUTSIDE_LOOP, {});
     }
-    return nullptr;
 }
 
-antlrcpp::Any
-TypeChecker::visitReturnStmt(DecafParserParser::ReturnStmtContext *ctx) {
+void TypeChecker::visitReturnStmt(ReturnStmt *node) {
+    attrManager->setHasRet(node, true);
 
-    attrManager->setHasRet(ctx, true);
-
-    if (!ctx->expr()) {
-        std::static_pointer_cast<Type>(std::make_shared<BuiltInType>(Type::VOID_TYPE));
+    std::shared_ptr<Type> rt;
+    if (node->expr) {
+        rt = visitExpr(node->expr);
+    } else {
+        rt = types->getBuiltIn(Type::VOID_TYPE);
     }
 
-    std::shared_ptr<Type> rt = visit(ctx->expr());
-
     if (rt->getKind() == Type::ERROR_TYPE) {
-        return rt;
+        return;
     }
 
-    Pos pos = getTokenPos(ctx->RETURN()->getSymbol());
     std::shared_ptr<Type> mrt =
         std::dynamic_pointer_cast<MethodType>(curMethod->type)->getRetType();
     if (!isCompat(rt, mrt)) {
-        fail(pos, CompileErrors::INCOMPAT_RETURN,
+        fail(node->pos, CompileErrors::INCOMPAT_RETURN,
              {rt->toString(), mrt->toString()});
-        return mrt;
     }
-    return mrt;
 }
 
-antlrcpp::Any
-TypeChecker::visitPrintStmt(DecafParserParser::PrintStmtContext *ctx) {
-
-    size_t n = ctx->exprList()->expr().size();
-    for (size_t i = 0; i < n; i++) {
-        DecafParserParser::ExprContext *expr = ctx->exprList()->expr(i);
-        std::shared_ptr<Type> argT = visit(expr);
+void TypeChecker::visitPrintStmt(PrintStmt *node) {
+    for (size_t i = 0; i < node->args.size(); i++) {
+        Expr *expr = node->args[i];
+        std::shared_ptr<Type> argT = visitExpr(expr);
 
         Type::TypeKind argTK = argT->getKind();
         if (argTK != Type::ERROR_TYPE && argTK != Type::INTEGER_TYPE &&
             argTK != Type::BOOL_TYPE && argTK != Type::STRING_TYPE) {
-            Pos pos = getTokenPos(expr->getStart());
-            fail(pos, CompileErrors::INCOMPAT_ARG,
+            fail(expr->pos, CompileErrors::INCOMPAT_ARG,
                  {std::to_string(i + 1), argT->toString(), "int/bool/string"});
         }
     }
-
-    return nullptr;
 }
 
-// antlrcpp::Any
-// visitLocalVarDefStmt(DecafParserParser::LocalVarDefStmtContext *ctx){}
-
-// antlrcpp::Any visitAssignStmt(DecafParserParser::AssignStmtContext
-// *ctx){}
+std::shared_ptr<Type> TypeChecker::visitIntLit(IntLit *node) {
+    return returnExprType(node, types->getBuiltIn(Type::INTEGER_TYPE));
+}
 
-antlrcpp::Any
-TypeChecker::visitVarSelLValue(DecafParserParser::VarSelLValueContext *ctx) {
-    if (ctx->DOT()) {
-        return checkVarSel(ctx->expr(), ctx->id());
-    } else {
-        return checkVar(ctx->id());
-    }
+std::shared_ptr<Type> TypeChecker::visitBoolLit(BoolLit *node) {
+    return returnExprType(node, types->getBuiltIn(Type::BOOL_TYPE));
 }
 
-antlrcpp::Any TypeChecker::visitIndexSelLValue(
-    DecafParserParser::IndexSelLValueContext *ctx) {
-    return checkIndexSel(ctx->expr(0), ctx->expr(1),
-                         getTokenPos(ctx->LBRACKET()->getSymbol()));
+std::shared_ptr<Type> TypeChecker::visitNullLit(NullLit *node) {
+    return returnExprType(node, types->getBuiltIn(Type::NULL_TYPE));
 }
 
-antlrcpp::Any
-TypeChecker::visitThisExpr(DecafParserParser::ThisExprContext *ctx) {
-    Pos pos = getThisPos(ctx);
+std::shared_ptr<Type> TypeChecker::visitStringLit(StringLit *node) {
+    return returnExprType(node, types->getBuiltIn(Type::STRING_TYPE));
+}
 
+std::shared_ptr<Type> TypeChecker::visitThisExpr(ThisExpr *node) {
     if (curMethod->isStatic()) {
-        fail(pos, CompileErrors::THIS_IN_STATIC, {});
-        return returnExprType(ctx, std::make_shared<ErrorType>());
+        fail(node->pos, CompileErrors::THIS_IN_STATIC, {});
+        return returnExprType(node, types->getError());
     }
-    return returnExprType(ctx, std::make_shared<ClassType>(curClass->name));
+    return returnExprType(node, curClass->type);
 }
 
-antlrcpp::Any TypeChecker::visitInstanceofExpr(
-    DecafParserParser::InstanceofExprContext *ctx) {
-    std::shared_ptr<Type> expr = visit(ctx->expr());
-    Type::TypeKind exprType = expr->getKind();
-    if (exprType != Type::ERROR_TYPE && exprType != Type::CLASS_TYPE) {
-        fail(getInstanceofPos(ctx), CompileErrors::NOT_CLASS,
-             {expr->toString()});
+std::shared_ptr<Type> TypeChecker::visitVarSel(VarSel *node) {
+    if (node->receiver) {
+        return returnExprType(node, checkVarSel(node));
     }
+    return returnExprType(node, checkVar(node));
+}
 
-    antlr4::Token *tok = ctx->id()->IDENTIFIER()->getSymbol();
-    std::string id = tok->getText();
-    std::shared_ptr<Symbol> classSym = cur->lookup(id);
-    // id must be a class's name
-    if (!classSym || classSym->getKind() != Symbol::CLASS) {
-        fail(getTokenPos(tok), CompileErrors::CLASS_NOT_FOUND, {id});
-    }
-    return returnExprType(ctx, std::make_shared<BuiltInType>(Type::BOOL_TYPE));
+std::shared_ptr<Type> TypeChecker::visitIndexSel(IndexSel *node) {
+    return returnExprType(node, checkIndexSel(node));
 }
 
-antlrcpp::Any
-TypeChecker::visitLocalCallExpr(DecafParserParser::LocalCallExprContext *ctx) {
-    std::string methodName = ctx->id()->IDENTIFIER()->getText();
-    Pos pos = getTokenPos(ctx->LPAREN()->getSymbol());
-    std::shared_ptr<Type> t = checkCall(curClass, methodName, ctx->exprList(), pos, true, false);
-    return returnExprType(ctx, t);
+std::shared_ptr<Type> TypeChecker::visitCall(Call *node) {
+    if (node->receiver) {
+        return returnExprType(node, checkVarCall(node));
+    }
+    std::shared_ptr<Type> t = checkCall(curClass, node->name, node->args,
+                                        node->lparenPos, true, false);
+    return returnExprType(node, t);
 }
 
-antlrcpp::Any TypeChecker::visitLogicalAndExpr(
-    DecafParserParser::LogicalAndExprContext *ctx) {
-    Pos pos = getTokenPos(ctx->bop);
+std::shared_ptr<Type> TypeChecker::visitParen(Paren *node) {
+    return returnExprType(node, visitExpr(node->expr));
+}
 
-    std::shared_ptr<Type> lh = visit(ctx->expr(0));
-    std::shared_ptr<Type> rh = visit(ctx->expr(1));
-    Type::TypeKind lt = lh->getKind();
-    Type::TypeKind rt = rh->getKind();
+std::shared_ptr<Type> TypeChecker::visitUnary(Unary *node) {
+    std::shared_ptr<Type> t = visitExpr(node->operand);
+    Type::TypeKind tk = t->getKind();
+    Type::TypeKind want =
+        node->op == Unary::NEG ? Type::INTEGER_TYPE : Type::BOOL_TYPE;
 
-    if (lt != Type::ERROR_TYPE && rt != Type::ERROR_TYPE &&
-        (lt != Type::BOOL_TYPE || rt != Type::BOOL_TYPE)) {
-        fail(pos, CompileErrors::INCOMPAT_BIN_OP,
-             {lh->toString(), ctx->bop->getText(), rh->toString()});
+    if (tk != Type::ERROR_TYPE && tk != want) {
+        fail(node->pos, CompileErrors::INCOMPAT_UN_OP,
+             {getOpText(node->op), t->toString()});
     }
-        return returnExprType(ctx, std::make_shared<BuiltInType>(Type::BOOL_TYPE));
+    return returnExprType(node, types->getBuiltIn(want));
 }
 
-antlrcpp::Any
-TypeChecker::visitLogicalOrExpr(DecafParserParser::LogicalOrExprContext *ctx) {
-    Pos pos = getTokenPos(ctx->bop);
-
-    std::shared_ptr<Type> lh = visit(ctx->expr(0));
-    std::shared_ptr<Type> rh = visit(ctx->expr(1));
+std::shared_ptr<Type> TypeChecker::visitBinary(Binary *node) {
+    std::shared_ptr<Type> lh = visitExpr(node->lhs);
+    std::shared_ptr<Type> rh = visitExpr(node->rhs);
     Type::TypeKind lt = lh->getKind();
     Type::TypeKind rt = rh->getKind();
 
-    if (lt != Type::ERROR_TYPE && rt != Type::ERROR_TYPE &&
-        (lt != Type::BOOL_TYPE || rt != Type::BOOL_TYPE)) {
-        fail(pos, CompileErrors::INCOMPAT_BIN_OP,
-             {lh->toString(), ctx->bop->getText(), rh->toString()});
+    // operand and result types
+    Type::TypeKind want, ret;
+    switch (node->op) {
+    case Binary::EQ:
+    case Binary::NE:
+        if (!isCompat(lh, rh) && !isCompat(rh, lh)) {
+            fail(node->opPos, CompileErrors::INCOMPAT_BIN_OP,
+                 {lh->toString(), getOpText(node->op), rh->toString()});
+        }
+        return returnExprType(node, types->getBuiltIn(Type::BOOL_TYPE));
+    case Binary::AND:
+    case Binary::OR:
+        want = Type::BOOL_TYPE;
+        ret = Type::BOOL_TYPE;
+        break;
+    case Binary::LE:
+    case Binary::LT:
+    case Binary::GE:
+    case Binary::GT:
+        want = Type::INTEGER_TYPE;
+        ret = Type::BOOL_TYPE;
+        break;
+    default:
+        want = Type::INTEGER_TYPE;
+        ret = Type::INTEGER_TYPE;
+        break;
     }
-    return returnExprType(ctx, std::make_shared<BuiltInType>(Type::BOOL_TYPE));
-}
-
-antlrcpp::Any
-TypeChecker::visitUnarySubExpr(DecafParserParser::UnarySubExprContext *ctx) {
-    Pos pos = getTokenPos(ctx->uop);
-    std::shared_ptr<Type> t = visit(ctx->expr());
-    Type::TypeKind tk = t->getKind();
 
-    if (tk != Type::ERROR_TYPE && tk != Type::INTEGER_TYPE) {
-        fail(pos, CompileErrors::INCOMPAT_UN_OP,
-             {ctx->uop->getText(), t->toString()});
+    if (lt != Type::ERROR_TYPE && rt != Type::ERROR_TYPE &&
+        (lt != want || rt != want)) {
+        fail(node->opPos, CompileErrors::INCOMPAT_BIN_OP,
+             {lh->toString(), getOpText(node->op), rh->toString()});
     }
-    return returnExprType(ctx, std::make_shared<BuiltInType>(Type::INTEGER_TYPE));
+    return returnExprType(node, types->getBuiltIn(ret));
 }
 
-antlrcpp::Any
-TypeChecker::visitCastExpr(DecafParserParser::CastExprContext *ctx) {
-    std::shared_ptr<Type> expr = visit(ctx->expr());
+std::shared_ptr<Type> TypeChecker::visitCast(Cast *node) {
+    std::shared_ptr<Type> expr = visitExpr(node->expr);
     Type::TypeKind exprType = expr->getKind();
     if (exprType != Type::ERROR_TYPE && exprType != Type::CLASS_TYPE) {
-        fail(getTokenPos(ctx->expr()->getStart()), CompileErrors::NOT_CLASS,
-             {expr->toString()});
+        fail(node->expr->pos, CompileErrors::NOT_CLASS, {expr->toString()});
     }
 
-    antlr4::Token *tok = ctx->id()->IDENTIFIER()->getSymbol();
-    std::string id = tok->getText();
+    Name id = node->className;
     std::shared_ptr<Symbol> classSym = cur->lookup(id);
     if (!classSym || classSym->getKind() != Symbol::CLASS) {
-        fail(getTokenPos(tok), CompileErrors::CLASS_NOT_FOUND, {id});
+        fail(node->classPos, CompileErrors::CLASS_NOT_FOUND, {id.str()});
+        return returnExprType(node, types->getError());
     }
 
-    return returnExprType(ctx, classSym->type);
+    return returnExprType(node, classSym->type);
 }
 
-antlrcpp::Any
-TypeChecker::visitClassNewExpr(DecafParserParser::ClassNewExprContext *ctx) {
-    std::string id = ctx->id()->IDENTIFIER()->getText();
-    Pos pos = getTokenPos(ctx->NEW()->getSymbol());
-
-    std::shared_ptr<Symbol> sym = cur->lookup(id);
-    if (sym && sym->getKind() == Symbol::CLASS) {
-        return returnExprType(ctx, std::make_shared<ClassType>(id));
-    } else {
-        fail(pos, CompileErrors::CLASS_NOT_FOUND, {id});
-        return returnExprType(ctx, std::make_shared<ErrorType>());
-    }
+std::shared_ptr<Type> TypeChecker::visitReadInt(ReadInt *node) {
+    return returnExprType(node, types->getBuiltIn(Type::INTEGER_TYPE));
 }
 
-antlrcpp::Any
-TypeChecker::visitReadLineExpr(DecafParserParser::ReadLineExprContext *ctx) {
-    return returnExprType(ctx, std::make_shared<BuiltInType>(Type::STRING_TYPE));
+std::shared_ptr<Type> TypeChecker::visitReadLine(ReadLine *node) {
+    return returnExprType(node, types->getBuiltIn(Type::STRING_TYPE));
 }
 
-antlrcpp::Any
-TypeChecker::visitAddictiveExpr(DecafParserParser::AddictiveExprContext *ctx) {
-    Pos pos = getTokenPos(ctx->bop);
-    std::shared_ptr<Type> lh = visit(ctx->expr(0));
-    std::shared_ptr<Type> rh = visit(ctx->expr(1));
-    Type::TypeKind lt = lh->getKind();
-    Type::TypeKind rt = rh->getKind();
-    if (lt != Type::ERROR_TYPE && rt != Type::ERROR_TYPE &&
-        (lt != Type::INTEGER_TYPE || rt != Type::INTEGER_TYPE)) {
-        fail(pos, CompileErrors::INCOMPAT_BIN_OP,
-             {lh->toString(), ctx->bop->getText(), rh->toString()});
-    }
-    return returnExprType(ctx, std::make_shared<BuiltInType>(Type::INTEGER_TYPE));
-}
+std::shared_ptr<Type> TypeChecker::visitClassNew(ClassNew *node) {
+    Name id = node->className;
 
-antlrcpp::Any
-TypeChecker::visitIndexSelExpr(DecafParserParser::IndexSelExprContext *ctx) {
-    return returnExprType(ctx, checkIndexSel(ctx->expr(0), ctx->expr(1),
-                         getTokenPos(ctx->LBRACKET()->getSymbol())));
-}
-
-antlrcpp::Any
-TypeChecker::visitParenExpr(DecafParserParser::ParenExprContext *ctx) {
-    return returnExprType(ctx, visit(ctx->expr()));
-}
-
-antlrcpp::Any
-TypeChecker::visitVarSelExpr(DecafParserParser::VarSelExprContext *ctx) {
-    return returnExprType(ctx, checkVarSel(ctx->expr(), ctx->id()));
+    std::shared_ptr<Symbol> sym = cur->lookup(id);
+    if (sym && sym->getKind() == Symbol::CLASS) {
+        return returnExprType(node, types->getClass(id));
+    } else {
+        fail(node->pos, CompileErrors::CLASS_NOT_FOUND, {id.str()});
+        return returnExprType(node, types->getError());
+    }
 }
 
-antlrcpp::Any
-TypeChecker::visitArrayNewExpr(DecafParserParser::ArrayNewExprContext *ctx) {
-    std::shared_ptr<Type> base = visit(ctx->type());
-    std::shared_ptr<Type> idx = visit(ctx->expr());
+std::shared_ptr<Type> TypeChecker::visitArrayNew(ArrayNew *node) {
+    std::shared_ptr<Type> base = getType(node->elemType);
+    std::shared_ptr<Type> idx = visitExpr(node->length);
 
-    Pos idxPos = getTokenPos(ctx->expr()->start);
     Type::TypeKind idxType = idx->getKind();
 
     if (idxType != Type::ERROR_TYPE && idxType != Type::INTEGER_TYPE) {
-        fail(idxPos, CompileErrors::NEW_ARRY_LEN_NOT_INT, {});
+        fail(node->length->pos, CompileErrors::NEW_ARRY_LEN_NOT_INT, {});
     }
 
     if (base->getKind() == Type::ERROR_TYPE) {
-        return returnExprType(ctx, base);
+        return returnExprType(node, base);
     } else {
-        return returnExprType(ctx, std::make_shared<ArrayType>(base));
+        return returnExprType(node, types->getArray(base));
     }
 }
 
-antlrcpp::Any
-TypeChecker::visitReadIntExpr(DecafParserParser::ReadIntExprContext *ctx) {
-    return returnExprType(ctx, std::make_shared<BuiltInType>(Type::INTEGER_TYPE));
-}
-
-antlrcpp::Any
-TypeChecker::visitVarCallExpr(DecafParserParser::VarCallExprContext *ctx) {
-
-    allowClassName = true;
-    std::shared_ptr<Type> exprT = visit(ctx->expr());
-    allowClassName = false;
-
-    std::string methodName = ctx->id()->IDENTIFIER()->getSymbol()->getText();
-    Pos pos = getTokenPos(ctx->LPAREN()->getSymbol());
-
-    if (exprT->getKind() == Type::ERROR_TYPE) {
-        return returnExprType(ctx, exprT);
-    }
-
-    // pre-defined "length()" for array
-    // NO arguments to array.length()
-    if (exprT->getKind() == Type::ARRAY_TYPE && methodName == "length") {
-        size_t argCount = ctx->exprList()->expr().size();
-        if (argCount > 0) {
-            fail(pos, CompileErrors::BAD_ARG_COUNT,
-                 {"length", "0", std::to_string(argCount)});
-        }
-        return returnExprType(ctx, std::make_shared<BuiltInType>(Type::INTEGER_TYPE));
-    }
-
-    // cannot access field of non-CLASS type
-    if (exprT->getKind() != Type::CLASS_TYPE) {
-        fail(pos, CompileErrors::CANNOT_ACCESS_FIELD,
-             {methodName, exprT->toString()});
-        return returnExprType(ctx, std::make_shared<ErrorType>());
-    }
-
-    std::string className =
-        std::dynamic_pointer_cast<ClassType>(exprT)->getName();
-    std::shared_ptr<Symbol> classSym = global->lookup(className);
-    std::shared_ptr<Type> t = checkCall(classSym, methodName, ctx->exprList(), pos, false,
-                     attrManager->getIsClassName(ctx->expr()));
-    return returnExprType(ctx, t);
-}
-
-antlrcpp::Any
-TypeChecker::visitLitExpr(DecafParserParser::LitExprContext *ctx) {
-    return returnExprType(ctx, visitChildren(ctx));
-}
-
-antlrcpp::Any
-TypeChecker::visitUnaryNotExpr(DecafParserParser::UnaryNotExprContext *ctx) {
-    Pos pos = getTokenPos(ctx->uop);
-    std::shared_ptr<Type> t = visit(ctx->expr());
-    Type::TypeKind tk = t->getKind();
-
-    if (tk != Type::ERROR_TYPE && tk != Type::BOOL_TYPE) {
-        fail(pos, CompileErrors::INCOMPAT_UN_OP,
-             {ctx->uop->getText(), t->toString()});
-    }
-    return returnExprType(ctx, std::make_shared<BuiltInType>(Type::BOOL_TYPE));
-}
-
-antlrcpp::Any TypeChecker::visitMultiplicativeExpr(
-    DecafParserParser::MultiplicativeExprContext *ctx) {
-    Pos pos = getTokenPos(ctx->bop);
-
-    std::shared_ptr<Type> lh = visit(ctx->expr(0));
-    std::shared_ptr<Type> rh = visit(ctx->expr(1));
-    Type::TypeKind lt = lh->getKind();
-    Type::TypeKind rt = rh->getKind();
-
-    if (lt != Type::ERROR_TYPE && rt != Type::ERROR_TYPE &&
-        (lt != Type::INTEGER_TYPE || rt != Type::INTEGER_TYPE)) {
-        fail(pos, CompileErrors::INCOMPAT_BIN_OP,
-             {lh->toString(), ctx->bop->getText(), rh->toString()});
-    }
-    return returnExprType(ctx, std::make_shared<BuiltInType>(Type::INTEGER_TYPE));
-}
-
-antlrcpp::Any
-TypeChecker::visitRelationExpr(DecafParserParser::RelationExprContext *ctx) {
-    Pos pos = getTokenPos(ctx->bop);
-
-    std::shared_ptr<Type> lh = visit(ctx->expr(0));
-    std::shared_ptr<Type> rh = visit(ctx->expr(1));
-    Type::TypeKind lt = lh->getKind();
-    Type::TypeKind rt = rh->getKind();
-
-    if (lt != Type::ERROR_TYPE && rt != Type::ERROR_TYPE &&
-        (lt != Type::INTEGER_TYPE || rt != Type::INTEGER_TYPE)) {
-        fail(pos, CompileErrors::INCOMPAT_BIN_OP,
-             {lh->toString(), ctx->bop->getText(), rh->toString()});
-    }
-    return returnExprType(ctx, std::make_shared<BuiltInType>(Type::BOOL_TYPE));
-}
-
-antlrcpp::Any
-TypeChecker::visitEqualityExpr(DecafParserParser::EqualityExprContext *ctx) {
-    Pos pos = getTokenPos(ctx->bop);
-    std::shared_ptr<Type> lh = visit(ctx->expr(0));
-    std::shared_ptr<Type> rh = visit(ctx->expr(1));
-
-    if (!isCompat(lh, rh) && !isCompat(rh, lh)) {
-        fail(pos, CompileErrors::INCOMPAT_BIN_OP,
-             {lh->toString(), ctx->bop->getText(), rh->toString()});
+std::shared_ptr<Type> TypeChecker::visitInstanceof(Instanceof *node) {
+    std::shared_ptr<Type> expr = visitExpr(node->expr);
+    Type::TypeKind exprType = expr->getKind();
+    if (exprType != Type::ERROR_TYPE && exprType != Type::CLASS_TYPE) {
+        fail(node->pos, CompileErrors::NOT_CLASS, {expr->toString()});
     }
-    return returnExprType(ctx, std::make_shared<BuiltInType>(Type::BOOL_TYPE));
-}
 
-antlrcpp::Any TypeChecker::visitIdExpr(DecafParserParser::IdExprContext *ctx) {
-    std::shared_ptr<Type> vt = checkVar(ctx->id());
-    if (attrManager->getIsClassName(ctx->id())) {
-        attrManager->setIsClassName(ctx, true);
+    Name id = node->className;
+    std::shared_ptr<Symbol> classSym = cur->lookup(id);
+    // id must be a class's name
+    if (!classSym || classSym->getKind() != Symbol::CLASS) {
+        fail(node->classPos, CompileErrors::CLASS_NOT_FOUND, {id.str()});
     }
-    return returnExprType(ctx, vt);
-}
-
-// antlrcpp::Any
-// TypeChecker::visitExprList(DecafParserParser::ExprListContext *ctx) {
-//     std::vector<std::shared_ptr<Type>> typelist;
-
-//     for (auto &x : ctx->expr()) {
-//         std::shared_ptr<Type> t = visit(x);
-//         typelist.push_back(t);
-//     }
-//     return typelist;
-// }
-
-antlrcpp::Any TypeChecker::visitIntLit(DecafParserParser::IntLitContext *ctx) {
-    return std::static_pointer_cast<Type>(
-        std::make_shared<BuiltInType>(Type::INTEGER_TYPE));
-}
-
-antlrcpp::Any
-TypeChecker::visitBoolLit(DecafParserParser::BoolLitContext *ctx) {
-    return std::static_pointer_cast<Type>(
-        std::make_shared<BuiltInType>(Type::BOOL_TYPE));
-}
-
-antlrcpp::Any
-TypeChecker::visitNullLit(DecafParserParser::NullLitContext *ctx) {
-    return std::static_pointer_cast<Type>(
-        std::make_shared<BuiltInType>(Type::NULL_TYPE));
-}
-
-antlrcpp::Any
-TypeChecker::visitStringLit(DecafParserParser::StringLitContext *ctx) {
-    return std::static_pointer_cast<Type>(
-        std::make_shared<BuiltInType>(Type::STRING_TYPE));
+    return returnExprType(node, types->getBuiltIn(Type::BOOL_TYPE));
 }
 
 bool TypeChecker::checkArgs(std::shared_ptr<Symbol> methodSym, Pos callPos,
-                            DecafParserParser::ExprListContext *argsCtx) {
+                            llvm::ArrayRef<Expr *> args) {
     std::vector<std::shared_ptr<Type>> parasType =
         (std::dynamic_pointer_cast<MethodType>(methodSym->type))->getArgsType();
 
-    if (argsCtx->expr().size() != parasType.size()) {
+    if (args.size() != parasType.size()) {
         fail(callPos, CompileErrors::BAD_ARG_COUNT,
-             {methodSym->name, std::to_string(parasType.size()),
-              std::to_string(argsCtx->expr().size())});
+             {methodSym->name.str(), std::to_string(parasType.size()),
+              std::to_string(args.size())});
         return false;
     }
 
     for (size_t i = 0; i < parasType.size(); i++) {
-        std::shared_ptr<Type> argT = visit(argsCtx->expr(i));
+        std::shared_ptr<Type> argT = visitExpr(args[i]);
         if (!isCompat(argT, parasType[i])) {
-            fail(getTokenPos(argsCtx->expr(i)->getStart()),
-                 CompileErrors::INCOMPAT_ARG,
+            fail(args[i]->pos, CompileErrors::INCOMPAT_ARG,
                  {std::to_string(i + 1), argT->toString(),
                   parasType[i]->toString()});
             return false;
@@ -653,22 +412,21 @@ bool TypeChecker::isCompat(std::shared_ptr<Type> a, std::shared_ptr<Type> b) {
 }
 
 std::shared_ptr<Type>
-TypeChecker::checkCall(std::shared_ptr<Symbol> classSym,
-                       const std::string &methodName,
-                       DecafParserParser::ExprListContext *exprlist,
-                       const Pos &pos, bool thisClass, bool isClassName) {
+TypeChecker::checkCall(std::shared_ptr<Symbol> classSym, Name methodName,
+                       llvm::ArrayRef<Expr *> args, const Pos &pos,
+                       bool thisClass, bool isClassName) {
     std::shared_ptr<Symbol> methodSym =
         classSym->getScope()->lookup(methodName);
     if (!methodSym) {
         fail(pos, CompileErrors::FIELD_NOT_FOUND,
-             {methodName, classSym->type->toString()});
-        return std::static_pointer_cast<Type>(std::make_shared<ErrorType>());
+             {methodName.str(), classSym->type->toString()});
+        return types->getError();
     }
 
     if (methodSym->getKind() != Symbol::METHOD) {
         fail(pos, CompileErrors::NOT_A_METHOD,
-             {methodName, curClass->type->toString()});
-        return std::static_pointer_cast<Type>(std::make_shared<ErrorType>());
+             {methodName.str(), curClass->type->toString()});
+        return types->getError();
     }
 
     // require called method to be static
@@ -676,64 +434,98 @@ TypeChecker::checkCall(std::shared_ptr<Symbol> classSym,
         if (curMethod->isStatic() && !methodSym->isStatic()) {
             if (isClassName) {
                 fail(pos, CompileErrors::CANNOT_ACCESS_FIELD,
-                     {methodName, classSym->type->toString()});
+                     {methodName.str(), classSym->type->toString()});
             } else {
                 fail(pos, CompileErrors::REF_NON_STATIC,
-                     {methodName, curMethod->name});
+                     {methodName.str(), curMethod->name.str()});
             }
-            return std::static_pointer_cast<Type>(
-                std::make_shared<ErrorType>());
+            return types->getError();
         }
     } else {
         if (isClassName && !methodSym->isStatic()) {
             fail(pos, CompileErrors::CANNOT_ACCESS_FIELD,
-                 {methodName, classSym->type->toString()});
-            return std::static_pointer_cast<Type>(
-                std::make_shared<ErrorType>());
+                 {methodName.str(), classSym->type->toString()});
+            return types->getError();
         }
     }
 
-    if (!checkArgs(methodSym, pos, exprlist)) {
-        return std::static_pointer_cast<Type>(std::make_shared<ErrorType>());
+    if (!checkArgs(methodSym, pos, args)) {
+        return types->getError();
     }
 
     return std::dynamic_pointer_cast<MethodType>(methodSym->type)->getRetType();
 }
 
-antlrcpp::Any TypeChecker::checkVarSel(DecafParserParser::ExprContext *exprCtx,
-                                       DecafParserParser::IdContext *idCtx) {
+std::shared_ptr<Type> TypeChecker::checkVarCall(Call *node) {
+    allowClassName = true;
+    std::shared_ptr<Type> exprT = visitExpr(node->receiver);
+    allowClassName = false;
+
+    Name methodName = node->name;
+    Pos pos = node->lparenPos;
+
+    if (exprT->getKind() == Type::ERROR_TYPE) {
+        return exprT;
+    }
+
+    // pre-defined "length()" for array
+    // NO arguments to array.length()
+    if (exprT->getKind() == Type::ARRAY_TYPE &&
+        methodName.getText() == "length") {
+        size_t argCount = node->args.size();
+        if (argCount > 0) {
+            fail(pos, CompileErrors::BAD_ARG_COUNT,
+                 {"length", "0", std::to_string(argCount)});
+        }
+        return types->getBuiltIn(Type::INTEGER_TYPE);
+    }
+
+    // cannot access field of non-CLASS type
+    if (exprT->getKind() != Type::CLASS_TYPE) {
+        fail(pos, CompileErrors::CANNOT_ACCESS_FIELD,
+             {methodName.str(), exprT->toString()});
+        return types->getError();
+    }
+
+    Name className = std::dynamic_pointer_cast<ClassType>(exprT)->getName();
+    std::shared_ptr<Symbol> classSym = global->lookup(className);
+    return checkCall(classSym, methodName, node->args, pos, false,
+                     attrManager->getIsClassName(node->receiver));
+}
+
+std::shared_ptr<Type> TypeChecker::checkVarSel(VarSel *node) {
     // prefix expr cannot be class name (e.g., MyClass.foo)
     // But for a better error hint, just allowed here
     allowClassName = true;
-    std::shared_ptr<Type> exprT = visit(exprCtx);
+    std::shared_ptr<Type> exprT = visitExpr(node->receiver);
     allowClassName = false;
 
     if (exprT->getKind() == Type::ERROR_TYPE) {
         return exprT;
     }
 
-    std::string varName = idCtx->IDENTIFIER()->getSymbol()->getText();
-    Pos pos = getIdPos(idCtx);
+    Name varName = node->name;
+    Pos pos = node->namePos;
 
     // prefix expr cannot be class name (e.g., MyClass.foo)
-    if (attrManager->getIsClassName(exprCtx)) {
+    if (attrManager->getIsClassName(node->receiver)) {
         fail(pos, CompileErrors::CANNOT_ACCESS_FIELD,
-             {varName, curClass->type->toString()});
-        return std::static_pointer_cast<Type>(std::make_shared<ErrorType>());
+             {varName.str(), curClass->type->toString()});
+        return types->getError();
     }
 
     // only class-variable has field
     if (exprT->getKind() != Type::CLASS_TYPE) {
         fail(pos, CompileErrors::CANNOT_ACCESS_FIELD,
-             {varName, exprT->toString()});
-        return std::static_pointer_cast<Type>(std::make_shared<ErrorType>());
+             {varName.str(), exprT->toString()});
+        return types->getError();
     }
 
     // cannot access protected fields of other unrelated classes
     if (!isCompat(curClass->type, exprT)) {
         fail(pos, CompileErrors::FIELD_NOT_ACCESS,
-             {varName, exprT->toString()});
-        return std::static_pointer_cast<Type>(std::make_shared<ErrorType>());
+             {varName.str(), exprT->toString()});
+        return types->getError();
     }
 
     // expr's class has no such member
@@ -742,35 +534,36 @@ antlrcpp::Any TypeChecker::checkVarSel(DecafParserParser::ExprContext *exprCtx,
     std::shared_ptr<Symbol> varSym = scope->lookup(varName);
     if (!varSym) {
         fail(pos, CompileErrors::FIELD_NOT_FOUND,
-             {varName, exprT->toString()});
-        return std::static_pointer_cast<Type>(std::make_shared<ErrorType>());
+             {varName.str(), exprT->toString()});
+        return types->getError();
     }
 
     // that member is not a field
     if (varSym->getKind() != Symbol::VAR) {
         fail(pos, CompileErrors::CANNOT_ACCESS_FIELD,
-             {varName, exprT->toString()});
-        return std::static_pointer_cast<Type>(std::make_shared<ErrorType>());
+             {varName.str(), exprT->toString()});
+        return types->getError();
     }
 
     if (curMethod->isStatic()) {
-        fail(pos, CompileErrors::REF_NON_STATIC, {varName, curMethod->name});
-        return std::static_pointer_cast<Type>(std::make_shared<ErrorType>());
+        fail(pos, CompileErrors::REF_NON_STATIC,
+             {varName.str(), curMethod->name.str()});
+        return types->getError();
     }
 
     return varSym->type;
 }
 
-antlrcpp::Any TypeChecker::checkVar(DecafParserParser::IdContext *idCtx) {
-    std::string id = idCtx->IDENTIFIER()->getText();
-    Pos pos = getIdPos(idCtx);
+std::shared_ptr<Type> TypeChecker::checkVar(VarSel *node) {
+    Name id = node->name;
+    Pos pos = node->namePos;
     // variables can not be used before defination
     std::shared_ptr<Symbol> preSym = cur->lookupBefore(pos, id);
 
     if (preSym) {
         // variable can be a class name
         if (allowClassName && preSym->getKind() == Symbol::CLASS) {
-            attrManager->setIsClassName(idCtx, true);
+            attrManager->setIsClassName(node, true);
             return preSym->type;
         }
 
@@ -778,38 +571,33 @@ antlrcpp::Any TypeChecker::checkVar(DecafParserParser::IdContext *idCtx) {
             // cannot access non-static field in static field
             bool isMember = preSym->getParent()->kind == Scope::Kind::CLASS;
             if (isMember && curMethod->isStatic()) {
-                fail(pos, CompileErrors::REF_NON_STATIC, {id, curMethod->name});
-                return std::static_pointer_cast<Type>(
-                    std::make_shared<ErrorType>());
+                fail(pos, CompileErrors::REF_NON_STATIC,
+                     {id.str(), curMethod->name.str()});
+                return types->getError();
             }
             return preSym->type;
         }
     }
 
-    fail(pos, CompileErrors::UNDECLARE_VAR, {id});
-    return std::static_pointer_cast<Type>(std::make_shared<ErrorType>());
+    fail(pos, CompileErrors::UNDECLARE_VAR, {id.str()});
+    return types->getError();
 }
 
-antlrcpp::Any
-TypeChecker::checkIndexSel(DecafParserParser::ExprContext *varExpr,
-                           DecafParserParser::ExprContext *idxExpr,
-                           const Pos &pos) {
-    std::shared_ptr<Type> ret =
-        std::static_pointer_cast<Type>(std::make_shared<ErrorType>());
+std::shared_ptr<Type> TypeChecker::checkIndexSel(IndexSel *node) {
+    std::shared_ptr<Type> ret = types->getError();
 
-    std::shared_ptr<Type> varT = visit(varExpr);
+    std::shared_ptr<Type> varT = visitExpr(node->array);
     Type::TypeKind varTK = varT->getKind();
     if (varTK == Type::ARRAY_TYPE) {
         ret = std::dynamic_pointer_cast<ArrayType>(varT)->getBase();
     } else if (varTK != Type::ERROR_TYPE) {
-        Pos p = getTokenPos(varExpr->getStart());
-        fail(p, CompileErrors::INDEX_SEL_NONARRAY, {});
+        fail(node->array->pos, CompileErrors::INDEX_SEL_NONARRAY, {});
     }
 
-    std::shared_ptr<Type> indexT = visit(idxExpr);
+    std::shared_ptr<Type> indexT = visitExpr(node->index);
     if (indexT->getKind() != Type::INTEGER_TYPE &&
         indexT->getKind() != Type::ERROR_TYPE) {
-        fail(pos, CompileErrors::BAD_ARRAY_INDEX, {});
+        fail(node->opPos, CompileErrors::BAD_ARRAY_INDEX, {});
     }
 
     return ret;
@@ -821,7 +609,8 @@ void TypeChecker::fail(const Pos &pos, CompileErrors err,
     reportErrorText(pos, err, texts);
 }
 
-std::shared_ptr<Type> TypeChecker::returnExprType(DecafParserParser::ExprContext *exprCtx, const std::shared_ptr<Type> &type) {
-    attrManager->setExprType(exprCtx, type);
+std::shared_ptr<Type>
+TypeChecker::returnExprType(Expr *expr, const std::shared_ptr<Type> &type) {
+    attrManager->setExprType(expr, type);
     return type;
 }
@@ -1,167 +1,81 @@
 #ifndef _TYPE_CHECKER_H_
 #define _TYPE_CHECKER_H_
 
-#include "DecafParserBaseVisitor.h"
-#include "DecafParserParser.h"
 #include "Scope.h"
 #include "Type.h"
-#include "antlr4-runtime.h"
+#include "ast/ASTVisitor.h"
 #include "utils/ASTAttrManager.h"
+#include "utils/CompileContext.h"
 #include "utils/printer.h"
 
-class TypeChecker : public DecafParserBaseVisitor {
+class TypeChecker : public ASTVisitor<TypeChecker, std::shared_ptr<Type>> {
 public:
-    TypeChecker(antlr4::tree::ParseTree *ast, std::shared_ptr<Scope> global,
-                std::shared_ptr<ASTAttrManager> am);
+    TypeChecker(TopLevel *ast, CompileContext &cc);
     bool check();
 
-    virtual antlrcpp::Any
-    visitClassDef(DecafParserParser::ClassDefContext *ctx) override;
+    void visitClassDef(ClassDef *node);
 
-    virtual antlrcpp::Any
-    visitMethodDef(DecafParserParser::MethodDefContext *ctx) override;
+    void visitMethodDef(MethodDef *node);
 
-    virtual antlrcpp::Any
-    visitStmt(DecafParserParser::StmtContext *ctx) override;
+    void visitBlock(Block *node);
 
-    virtual antlrcpp::Any
-    visitBlock(DecafParserParser::BlockContext *ctx) override;
+    void visitLocalVarDef(LocalVarDef *node);
 
-    virtual antlrcpp::Any
-    visitBlockStmt(DecafParserParser::BlockStmtContext *ctx) override;
+    void visitAssign(Assign *node);
 
-    virtual antlrcpp::Any
-    visitType(DecafParserParser::TypeContext *ctx) override;
+    void visitIfStmt(IfStmt *node);
 
-    virtual antlrcpp::Any
-    visitForControl(DecafParserParser::ForControlContext *ctx) override;
+    void visitWhileStmt(WhileStmt *node);
 
-    virtual antlrcpp::Any
-    visitLocalVarDef(DecafParserParser::LocalVarDefContext *ctx) override;
+    void visitForStmt(ForStmt *node);
 
-    virtual antlrcpp::Any
-    visitAssign(DecafParserParser::AssignContext *ctx) override;
+    void visitBreakStmt(BreakStmt *node);
 
-    virtual antlrcpp::Any
-    visitIfStmt(DecafParserParser::IfStmtContext *ctx) override;
+    void visitReturnStmt(ReturnStmt *node);
 
-    virtual antlrcpp::Any
-    visitWhileStmt(DecafParserParser::WhileStmtContext *ctx) override;
+    void visitPrintStmt(PrintStmt *node);
 
-    virtual antlrcpp::Any
-    visitForStmt(DecafParserParser::ForStmtContext *ctx) override;
+    std::shared_ptr<Type> visitIntLit(IntLit *node);
 
-    virtual antlrcpp::Any
-    visitBreakStmt(DecafParserParser::BreakStmtContext *ctx) override;
+    std::shared_ptr<Type> visitBoolLit(BoolLit *node);
 
-    virtual antlrcpp::Any
-    visitReturnStmt(DecafParserParser::ReturnStmtContext *ctx) override;
+    std::shared_ptr<Type> visitNullLit(NullLit *node);
 
-    virtual antlrcpp::Any
-    visitPrintStmt(DecafParserParser::PrintStmtContext *ctx) override;
+    std::shared_ptr<Type> visitStringLit(StringLit *node);
 
-    // virtual antlrcpp::Any
-    // visitLocalVarDefStmt(DecafParserParser::LocalVarDefStmtContext *ctx)
-    // override;
+    std::shared_ptr<Type> visitThisExpr(ThisExpr *node);
 
-    // virtual antlrcpp::Any
-    // visitAssignStmt(DecafParserParser::AssignStmtContext *ctx) override;
+    std::shared_ptr<Type> visitVarSel(VarSel *node);
 
-    virtual antlrcpp::Any
-    visitVarSelLValue(DecafParserParser::VarSelLValueContext *ctx) override;
+    std::shared_ptr<Type> visitIndexSel(IndexSel *node);
 
-    virtual antlrcpp::Any
-    visitIndexSelLValue(DecafParserParser::IndexSelLValueContext *ctx) override;
+    std::shared_ptr<Type> visitCall(Call *node);
 
-    virtual antlrcpp::Any
-    visitThisExpr(DecafParserParser::ThisExprContext *ctx) override;
+    std::shared_ptr<Type> visitParen(Paren *node);
 
-    virtual antlrcpp::Any
-    visitInstanceofExpr(DecafParserParser::InstanceofExprContext *ctx) override;
+    std::shared_ptr<Type> visitUnary(Unary *node);
 
-    virtual antlrcpp::Any
-    visitLocalCallExpr(DecafParserParser::LocalCallExprContext *ctx) override;
+    std::shared_ptr<Type> visitBinary(Binary *node);
 
-    virtual antlrcpp::Any
-    visitLogicalAndExpr(DecafParserParser::LogicalAndExprContext *ctx) override;
+    std::shared_ptr<Type> visitCast(Cast *node);
 
-    virtual antlrcpp::Any
-    visitLogicalOrExpr(DecafParserParser::LogicalOrExprContext *ctx) override;
+    std::shared_ptr<Type> visitReadInt(ReadInt *node);
 
-    virtual antlrcpp::Any
-    visitUnarySubExpr(DecafParserParser::UnarySubExprContext *ctx) override;
+    std::shared_ptr<Type> visitReadLine(ReadLine *node);
 
-    virtual antlrcpp::Any
-    visitCastExpr(DecafParserParser::CastExprContext *ctx) override;
+    std::shared_ptr<Type> visitClassNew(ClassNew *node);
 
-    virtual antlrcpp::Any
-    visitClassNewExpr(DecafParserParser::ClassNewExprContext *ctx) override;
+    std::shared_ptr<Type> visitArrayNew(ArrayNew *node);
 
-    virtual antlrcpp::Any
-    visitReadLineExpr(DecafParserParser::ReadLineExprContext *ctx) override;
-
-    virtual antlrcpp::Any
-    visitAddictiveExpr(DecafParserParser::AddictiveExprContext *ctx) override;
-
-    virtual antlrcpp::Any
-    visitIndexSelExpr(DecafParserParser::IndexSelExprContext *ctx) override;
-
-    virtual antlrcpp::Any
-    visitParenExpr(DecafParserParser::ParenExprContext *ctx) override;
-
-    virtual antlrcpp::Any
-    visitVarSelExpr(DecafParserParser::VarSelExprContext *ctx) override;
-
-    virtual antlrcpp::Any
-    visitArrayNewExpr(DecafParserParser::ArrayNewExprContext *ctx) override;
-
-    virtual antlrcpp::Any
-    visitReadIntExpr(DecafParserParser::ReadIntExprContext *ctx) override;
-
-    virtual antlrcpp::Any
-    visitVarCallExpr(DecafParserParser::VarCallExprContext *ctx) override;
-
-    virtual antlrcpp::Any
-    visitLitExpr(DecafParserParser::LitExprContext *ctx) override;
-
-    virtual antlrcpp::Any
-    visitUnaryNotExpr(DecafParserParser::UnaryNotExprContext *ctx) override;
-
-    virtual antlrcpp::Any visitMultiplicativeExpr(
-        DecafParserParser::MultiplicativeExprContext *ctx) override;
-
-    virtual antlrcpp::Any
-    visitRelationExpr(DecafParserParser::RelationExprContext *ctx) override;
-
-    virtual antlrcpp::Any
-    visitEqualityExpr(DecafParserParser::EqualityExprContext *ctx) override;
-
-    virtual antlrcpp::Any
-    visitIdExpr(DecafParserParser::IdExprContext *ctx) override;
-
-    // virtual antlrcpp::Any visitId(DecafParserParser::IdContext *ctx)
-    // override;
-
-    // virtual antlrcpp::Any
-    // visitExprList(DecafParserParser::ExprListContext *ctx) override;
-
-    virtual antlrcpp::Any
-    visitIntLit(DecafParserParser::IntLitContext *ctx) override;
-
-    virtual antlrcpp::Any
-    visitBoolLit(DecafParserParser::BoolLitContext *ctx) override;
-
-    virtual antlrcpp::Any
-    visitNullLit(DecafParserParser::NullLitContext *ctx) override;
-
-    virtual antlrcpp::Any
-    visitStringLit(DecafParserParser::StringLitContext *ctx) override;
+    std::shared_ptr<Type> visitInstanceof(Instanceof *node);
 
 private:
-    antlr4::tree::ParseTree *ast;
+    TopLevel *ast;
     std::shared_ptr<Scope> global;
     std::shared_ptr<Scope> cur;
     std::shared_ptr<ASTAttrManager> attrManager;
+    BaseChecker *baseChecker;
+    TypeFactory *types;
 
     bool typeFailed = false;
 
@@ -172,28 +86,28 @@ private:
     bool allowClassName = false;
 
     bool checkArgs(std::shared_ptr<Symbol> methodSym, Pos callPos,
-                   DecafParserParser::ExprListContext *argsCtx);
+                   llvm::ArrayRef<Expr *> args);
     bool isCompat(std::shared_ptr<Type> a, std::shared_ptr<Type> b);
 
     std::shared_ptr<Type>
-    checkCall(std::shared_ptr<Symbol> classSym, const std::string &methodName,
-              DecafParserParser::ExprListContext *exprlist, const Pos &pos,
-              bool thisClass, bool isClassName);
+    checkCall(std::shared_ptr<Symbol> classSym, Name methodName,
+              llvm::ArrayRef<Expr *> args, const Pos &pos, bool thisClass,
+              bool isClassName);
+
+    std::shared_ptr<Type> checkVarCall(Call *node);
 
-    antlrcpp::Any checkVarSel(DecafParserParser::ExprContext *exprCtx,
-                              DecafParserParser::IdContext *idCtx);
+    std::shared_ptr<Type> checkVarSel(VarSel *node);
 
-    antlrcpp::Any checkVar(DecafParserParser::IdContext *idCtx);
+    std::shared_ptr<Type> checkVar(VarSel *node);
 
-    antlrcpp::Any checkIndexSel(DecafParserParser::ExprContext *varExpr,
-                                DecafParserParser::ExprContext *idxExpr,
-                                const Pos &pos);
+    std::shared_ptr<Type> checkIndexSel(IndexSel *node);
+
+    std::shared_ptr<Type> getType(TypeLit *node);
 
     void fail(const Pos &pos, CompileErrors err,
               const std::vector<std::string> &texts);
-    std::shared_ptr<Type>
-    returnExprType(DecafParserParser::ExprContext *exprCtx,
-                   const std::shared_ptr<Type> &type);
+    std::shared_ptr<Type> returnExprType(Expr *expr,
+                                         const std::shared_ptr<Type> &type);
 };
 
-#endif
\ No newline at end of file
+#endif
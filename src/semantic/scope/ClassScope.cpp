@@ -1,11 +1,10 @@
 #include "ClassScope.h"
-#include "BaseChecker.h"
+#include "ClassSymbol.h"
 #include "utils/printer.h"
 
 ClassScope::ClassScope() { kind = Kind::CLASS; }
 
-bool ClassScope::declare(const std::string &name,
-                         std::shared_ptr<Symbol> symbol) {
+bool ClassScope::declare(Name name, std::shared_ptr<Symbol> symbol) {
     if (symbol->getKind() == Symbol::VAR) {
         return declareVar(name, symbol);
     } else if (symbol->getKind() == Symbol::METHOD) {
@@ -14,7 +13,7 @@ bool ClassScope::declare(const std::string &name,
     return false;
 }
 
-std::shared_ptr<Symbol> ClassScope::lookup(const std::string &name) {
+std::shared_ptr<Symbol> ClassScope::lookup(Name name) {
     std::shared_ptr<Symbol> sym;
 
     sym = lookupThis(name);
@@ -35,71 +34,71 @@ std::shared_ptr<Symbol> ClassScope::lookup(const std::string &name) {
     return sym;
 }
 
-void ClassScope::print(int level) {
+void ClassScope::print(std::ostream &os, int level) {
     std::string indent = printIdent(level);
     std::string innerIndent = printIdent(level + 1);
     std::vector<std::shared_ptr<Symbol>> orderedSymbols = getOrderedSymbols();
 
-    std::cout << indent << "CLASS SCOPE OF '" << name << "':" << std::endl;
+    os << indent << "CLASS SCOPE OF '" << name << "':" << std::endl;
     if (orderedSymbols.empty()) {
-        std::cout << innerIndent << "<empty>" << std::endl;
+        os << innerIndent << "<empty>" << std::endl;
     } else {
         for (auto &x : orderedSymbols) {
-            std::cout << innerIndent << x->toString() << std::endl;
+            os << innerIndent << x->toString() << std::endl;
         }
         for (auto &x : orderedSymbols) {
             if (x->getKind() == Symbol::METHOD) {
-                scopes.find(x->pos)->second->print(level + 1);
+                x->getScope()->print(os, level + 1);
             }
         }
     }
 }
 
-bool ClassScope::declareVar(const std::string &name,
-                            std::shared_ptr<Symbol> symbol) {
+bool ClassScope::declareVar(Name name, std::shared_ptr<Symbol> symbol) {
     std::shared_ptr<Symbol> preSym = lookup(name);
 
     if (preSym) {
         if (preSym->getParent() != shared_from_this() &&
             preSym->getKind() == Symbol::VAR) {
             reportErrorText(symbol->pos, CompileErrors::OVERRIDE_VAR,
-                            {preSym->name});
+                            {preSym->name.str()});
             return false;
         } else {
             reportErrorText(symbol->pos, CompileErrors::CONFLICT_DECLAR,
-                            {preSym->name, preSym->pos.toString()});
+                            {preSym->name.str(), preSym->pos.toString()});
             return false;
         }
     }
 
     if (symbol->type->getKind() == Type::VOID_TYPE) {
         reportErrorText(symbol->pos, CompileErrors::VOID_IDENTIFIER,
-                        {symbol->name});
+                        {symbol->name.str()});
         return false;
     }
     return Scope::declare(name, symbol);
 }
 
-bool ClassScope::declareMethod(const std::string &name,
-                               std::shared_ptr<Symbol> symbol) {
+bool ClassScope::declareMethod(Name name, std::shared_ptr<Symbol> symbol) {
     std::shared_ptr<Symbol> preSym = lookup(name);
 
     if (preSym) {
         if (isMethodConflicted(preSym)) {
             reportErrorText(symbol->pos, CompileErrors::CONFLICT_DECLAR,
-                            {preSym->name, preSym->pos.toString()});
+                            {preSym->name.str(), preSym->pos.toString()});
             return false;
         } else if (!isMethodOverrided(preSym, symbol)) {
             reportErrorText(symbol->pos, CompileErrors::OVERRIDE_METHOD,
-                            {preSym->name, preSym->getParent()->name});
+                            {preSym->name.str(),
+                             preSym->getParent()->name.str()});
             return false;
         }
     }
     return Scope::declare(name, symbol);
 }
 
-std::shared_ptr<Symbol> ClassScope::lookupInBase(const std::string &name) {
-    std::string basename = BaseChecker::getBase(this->name);
+std::shared_ptr<Symbol> ClassScope::lookupInBase(Name name) {
+    Name basename =
+        std::static_pointer_cast<ClassSymbol>(getSymbol())->getBase();
     std::shared_ptr<Symbol> sym = nullptr;
 
     if (!basename.empty()) {
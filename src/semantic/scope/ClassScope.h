@@ -6,14 +6,14 @@
 class ClassScope : public Scope {
 public:
     ClassScope();
-    virtual bool declare(const std::string &name, std::shared_ptr<Symbol> symbol) override;
-    virtual std::shared_ptr<Symbol> lookup(const std::string &name) override;
-    virtual void print(int level) override;
+    virtual bool declare(Name name, std::shared_ptr<Symbol> symbol) override;
+    virtual std::shared_ptr<Symbol> lookup(Name name) override;
+    virtual void print(std::ostream &os, int level) override;
     
 private:
-    bool declareVar(const std::string &name, std::shared_ptr<Symbol> symbol);
-    bool declareMethod(const std::string &name, std::shared_ptr<Symbol> symbol);
-    std::shared_ptr<Symbol> lookupInBase(const std::string &name);
+    bool declareVar(Name name, std::shared_ptr<Symbol> symbol);
+    bool declareMethod(Name name, std::shared_ptr<Symbol> symbol);
+    std::shared_ptr<Symbol> lookupInBase(Name name);
     bool isMethodConflicted(std::shared_ptr<Symbol> preSym);
     bool isMethodOverrided(std::shared_ptr<Symbol> preSym, std::shared_ptr<Symbol> newSym);
 };
@@ -3,14 +3,13 @@
 
 FormalScope::FormalScope() { kind = Scope::FORMAL; }
 
-bool FormalScope::declare(const std::string &name,
-                          std::shared_ptr<Symbol> symbol) {
+bool FormalScope::declare(Name name, std::shared_ptr<Symbol> symbol) {
     std::shared_ptr<Symbol> preSym = lookupThis(name);
 
     // Check Conflicts
     if (preSym) {
         reportErrorText(symbol->pos, CompileErrors::CONFLICT_DECLAR,
-                        {preSym->name, preSym->pos.toString()});
+                        {preSym->name.str(), preSym->pos.toString()});
         return false;
     } else {
         Scope::declare(symbol->name, symbol);
@@ -22,22 +21,22 @@ bool FormalScope::declare(const std::string &name,
     }
 }
 
-void FormalScope::print(int level) {
+void FormalScope::print(std::ostream &os, int level) {
     std::string indent = printIdent(level);
     std::string innerIndent = printIdent(level + 1);
     std::vector<std::shared_ptr<Symbol>> orderedSymbols = getOrderedSymbols();
     std::vector<std::shared_ptr<Scope>> orderedScopes = getOrderedScopes();
 
-    std::cout << indent << "FORMAL SCOPE OF '" << name << "':" << std::endl;
+    os << indent << "FORMAL SCOPE OF '" << name << "':" << std::endl;
     if (orderedSymbols.empty()) {
-        std::cout << innerIndent << "<empty>" << std::endl;
+        os << innerIndent << "<empty>" << std::endl;
     } else {
         for (auto &x : orderedSymbols) {
-            std::cout << innerIndent << x->toString() << std::endl;
+            os << innerIndent << x->toString() << std::endl;
         }
     }
     for (auto &x : orderedScopes) {
-        x->print(level + 1);
+        x->print(os, level + 1);
     }
 }
 std::vector<std::shared_ptr<Symbol>> FormalScope::getParams() {
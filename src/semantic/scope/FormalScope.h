@@ -6,9 +6,8 @@
 class FormalScope : public Scope {
 public:
     FormalScope();
-    virtual bool declare(const std::string &name,
-                         std::shared_ptr<Symbol> symbol) override;
-    virtual void print(int level) override;
+    virtual bool declare(Name name, std::shared_ptr<Symbol> symbol) override;
+    virtual void print(std::ostream &os, int level) override;
 
     // Use this function to get list of params in right order. If we use
     // 'getOrderedSymbols()' from 'Scope', the order will be messed up because
@@ -6,28 +6,27 @@ GlobalScope::GlobalScope() {
     parent = std::weak_ptr<Scope>();
 }
 
-bool GlobalScope::declare(const std::string &name,
-                          std::shared_ptr<Symbol> symbol) {
+bool GlobalScope::declare(Name name, std::shared_ptr<Symbol> symbol) {
     std::shared_ptr<Symbol> preSym = lookupThis(name);
     if (preSym) {
         reportErrorText(symbol->pos, CompileErrors::CONFLICT_DECLAR,
-                        {preSym->name, preSym->pos.toString()});
+                        {preSym->name.str(), preSym->pos.toString()});
         return false;
     }
 
     return Scope::declare(name, symbol);
 }
 
-void GlobalScope::print(int level) {
+void GlobalScope::print(std::ostream &os, int level) {
     std::string indent = printIdent(level);
     std::string innerIndent = printIdent(level + 1);
     std::vector<std::shared_ptr<Symbol>> orderedSymbols = getOrderedSymbols();
 
-    std::cout << indent << "GLOBAL SCOPE:" << std::endl;
+    os << indent << "GLOBAL SCOPE:" << std::endl;
     for (auto &x : orderedSymbols) {
-        std::cout << innerIndent << x->toString() << std::endl;
+        os << innerIndent << x->toString() << std::endl;
     }
     for (auto &x : orderedSymbols) {
-        scopes.find(x->pos)->second->print(level + 1);
+        x->getScope()->print(os, level + 1);
     }
 }
\ No newline at end of file
@@ -6,8 +6,8 @@
 class GlobalScope : public Scope {
 public:
     GlobalScope();
-    virtual bool declare(const std::string &name, std::shared_ptr<Symbol> symbol) override;
-    virtual void print(int level) override;
+    virtual bool declare(Name name, std::shared_ptr<Symbol> symbol) override;
+    virtual void print(std::ostream &os, int level) override;
 };
 
 #endif
\ No newline at end of file
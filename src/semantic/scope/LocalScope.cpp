@@ -3,8 +3,7 @@
 
 LocalScope::LocalScope() { kind = Kind::LOCAL; }
 
-std::shared_ptr<Symbol> LocalScope::lookupBefore(const Pos &pos,
-                                                 const std::string &name) {
+std::shared_ptr<Symbol> LocalScope::lookupBefore(const Pos &pos, Name name) {
     auto res = lookupThis(name);
     auto p = getParent();
 
@@ -15,41 +14,41 @@ std::shared_ptr<Symbol> LocalScope::lookupBefore(const Pos &pos,
     }
 }
 
-bool LocalScope::declare(const std::string &name,
-                         std::shared_ptr<Symbol> symbol) {
+bool LocalScope::declare(Name name, std::shared_ptr<Symbol> symbol) {
     std::shared_ptr<Symbol> preSym = lookup(name);
 
     // local-variable and class-field may have same name
     if (preSym && preSym->getParent()->kind != Scope::CLASS) {
         reportErrorText(symbol->pos, CompileErrors::CONFLICT_DECLAR,
-                        {name, preSym->pos.toString()});
+                        {name.str(), preSym->pos.toString()});
         return false;
     }
 
     // no void-type variable
     if (symbol->type->getKind() == Type::VOID_TYPE) {
-        reportErrorText(symbol->pos, CompileErrors::VOID_IDENTIFIER, {name});
+        reportErrorText(symbol->pos, CompileErrors::VOID_IDENTIFIER,
+                        {name.str()});
         return false;
     }
 
     return Scope::declare(name, symbol);
 }
 
-void LocalScope::print(int level) {
+void LocalScope::print(std::ostream &os, int level) {
     std::string indent = printIdent(level);
     std::string innerIndent = printIdent(level + 1);
     std::vector<std::shared_ptr<Symbol>> orderedSymbols = getOrderedSymbols();
     std::vector<std::shared_ptr<Scope>> orderedScopes = getOrderedScopes();
 
-    std::cout << indent << "LOCAL SCOPE:" << std::endl;
+    os << indent << "LOCAL SCOPE:" << std::endl;
     if (orderedSymbols.empty()) {
-        std::cout << innerIndent << "<empty>" << std::endl;
+        os << innerIndent << "<empty>" << std::endl;
     } else {
         for (auto &x : orderedSymbols) {
-            std::cout << innerIndent << x->toString() << std::endl;
+            os << innerIndent << x->toString() << std::endl;
         }
     }
     for (auto &x : orderedScopes) {
-        x->print(level + 1);
+        x->print(os, level + 1);
     }
 }
\ No newline at end of file
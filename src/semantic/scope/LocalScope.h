@@ -6,10 +6,9 @@
 class LocalScope : public Scope {
 public:
     LocalScope();
-    virtual std::shared_ptr<Symbol>
-    lookupBefore(const Pos &pos, const std::string &name) override;
-    virtual bool declare(const std::string &name,
-                         std::shared_ptr<Symbol> symbol) override;
-    virtual void print(int level) override;
+    virtual std::shared_ptr<Symbol> lookupBefore(const Pos &pos,
+                                                 Name name) override;
+    virtual bool declare(Name name, std::shared_ptr<Symbol> symbol) override;
+    virtual void print(std::ostream &os, int level) override;
 };
 #endif
\ No newline at end of file
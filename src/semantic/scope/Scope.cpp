@@ -13,7 +13,7 @@ std::shared_ptr<Symbol> Scope::getSymbol() { return selfSymbol.lock(); }
 
 void Scope::setSymbol(std::shared_ptr<Symbol> s) { selfSymbol = s; }
 
-std::shared_ptr<Symbol> Scope::lookup(const std::string &name) {
+std::shared_ptr<Symbol> Scope::lookup(Name name) {
     if (name.empty()) {
         return nullptr;
     }
@@ -26,23 +26,21 @@ std::shared_ptr<Symbol> Scope::lookup(const std::string &name) {
     return res;
 }
 
-std::shared_ptr<Symbol> Scope::lookupBefore(const Pos &pos,
-                                            const std::string &name) {
+std::shared_ptr<Symbol> Scope::lookupBefore(const Pos &pos, Name name) {
     (void)pos;
     return lookup(name);
 }
 
-bool Scope::declare(const std::string &name, std::shared_ptr<Symbol> symbol) {
+bool Scope::declare(Name name, std::shared_ptr<Symbol> symbol) {
     symbol->setParent(shared_from_this());
 
-    std::pair<std::string, std::shared_ptr<Symbol>> p = {name, symbol};
+    std::pair<Name, std::shared_ptr<Symbol>> p = {name, symbol};
 
     auto res = symbols.insert(p);
     return res.second;
 }
 
-std::shared_ptr<Scope> Scope::createScope(const Pos &p,
-                                          const std::string &name) {
+std::shared_ptr<Scope> Scope::createScope(const Pos &p, Name name) {
     std::shared_ptr<Scope> scope;
     if (kind == Kind::GLOBAL) {
         scope = std::make_shared<ClassScope>();
@@ -55,23 +53,13 @@ std::shared_ptr<Scope> Scope::createScope(const Pos &p,
     scope->pos = p;
     scope->name = name;
     scope->setParent(shared_from_this());
-    std::pair<Pos, std::shared_ptr<Scope>> pair = {p, scope};
-    scopes.insert(pair);
+    scopes.push_back(scope);
     return scope;
 }
 
-std::shared_ptr<Scope> Scope::enterScope(const Pos &p) {
-    auto iter = scopes.find(p);
-    if (iter != scopes.end()) {
-        return iter->second;
-    } else {
-        return nullptr;
-    }
-}
-
 std::shared_ptr<Scope> Scope::exitScope() { return parent.lock(); }
 
-std::shared_ptr<Symbol> Scope::lookupThis(const std::string &name) {
+std::shared_ptr<Symbol> Scope::lookupThis(Name name) {
     auto iter = symbols.find(name);
     if (iter != symbols.end()) {
         return iter->second;
@@ -80,7 +68,7 @@ std::shared_ptr<Symbol> Scope::lookupThis(const std::string &name) {
     }
 }
 
-std::shared_ptr<Symbol> Scope::lookupParent(const std::string &name) {
+std::shared_ptr<Symbol> Scope::lookupParent(Name name) {
     auto p = parent.lock();
     if (!p) {
         return nullptr;
@@ -106,17 +94,11 @@ std::vector<std::shared_ptr<Symbol>> Scope::getOrderedSymbols() {
 }
 
 std::vector<std::shared_ptr<Scope>> Scope::getOrderedScopes() {
-    std::vector<Pos> keys;
-
-    keys.reserve(scopes.size());
-    for (auto &it : scopes) {
-        keys.push_back(it.first);
-    }
-    std::sort(keys.begin(), keys.end());
-
-    std::vector<std::shared_ptr<Scope>> res;
-    for (Pos &key : keys) {
-        res.push_back(scopes.find(key)->second);
-    }
+    std::vector<std::shared_ptr<Scope>> res = scopes;
+    std::stable_sort(res.begin(), res.end(),
+                     [](const std::shared_ptr<Scope> &a,
+                        const std::shared_ptr<Scope> &b) {
+                         return a->pos < b->pos;
+                     });
     return res;
 }
\ No newline at end of file
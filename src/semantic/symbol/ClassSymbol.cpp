@@ -1,19 +1,23 @@
 #include "ClassSymbol.h"
 #include "BaseChecker.h"
 
-ClassSymbol::ClassSymbol() { kind = Kind::CLASS; }
+ClassSymbol::ClassSymbol(const BaseChecker *bc) : baseChecker(bc) {
+    kind = Kind::CLASS;
+}
 
 ClassSymbol::~ClassSymbol() {}
 
 std::string ClassSymbol::toString() {
     std::string s;
-    std::string base;
+    Name base;
 
-    s.append(pos.toString()).append(" -> class ").append(name);
+    s.append(pos.toString()).append(" -> class ").append(name.str());
     
-    base = BaseChecker::getBase(name);
+    base = getBase();
     if (!base.empty()) {
-        s.append(" : ").append(base);
+        s.append(" : ").append(base.str());
     }
     return s;
-}
\ No newline at end of file
+}
+
+Name ClassSymbol::getBase() const { return baseChecker->getBase(name); }
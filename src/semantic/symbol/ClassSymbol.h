@@ -2,12 +2,18 @@
 #define _CLASS_SYMBOL_H_
 #include "Symbol.h"
 
+class BaseChecker;
+
 class ClassSymbol : public Symbol
 {
 public:
-    ClassSymbol();
+    ClassSymbol(const BaseChecker *bc);
     virtual ~ClassSymbol();
     virtual std::string toString() override;
+    Name getBase() const;
+
+private:
+    const BaseChecker *baseChecker;
 };
 
 #endif
\ No newline at end of file
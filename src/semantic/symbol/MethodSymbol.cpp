@@ -11,7 +11,10 @@ std::string MethodSymbol::toString() {
     if (isStatic()) {
         s.append("STATIC ");
     }
-    s.append("function ").append(name).append(" : ").append(type->toString());
+    s.append("function ")
+        .append(name.str())
+        .append(" : ")
+        .append(type->toString());
 
     return s;
 }
\ No newline at end of file
@@ -11,7 +11,7 @@ std::string VarSymbol::toString() {
         .append(" -> ")
         .append("variable ")
         .append(isParam() ? "@" : "")
-        .append(name)
+        .append(name.str())
         .append(" : ")
         .append(type->toString());
     return s;
@@ -9,16 +9,12 @@ Type::Relation ArrayType::compare(const std::shared_ptr<Type> other) const {
         return SUBTYPE;
     }
     
-    if (other->getKind() != ARRAY_TYPE) {
-        return DIFFTPYE;
-    }
-
-    const std::shared_ptr<ArrayType> o = std::dynamic_pointer_cast<ArrayType>(other);
-    if (base->compare(o->getBase()) == SAMETPYE) {
-        return SAMETPYE;
-    } else {
+    // array types are canonical, different ones never have the same base
+    if (other.get() != this) {
         return DIFFTPYE;
     }
+    // but an array of errors is not even the same as itself
+    return base->compare(base) == SAMETPYE ? SAMETPYE : DIFFTPYE;
 }
 
 std::string ArrayType::toString() const {
@@ -1,46 +1,79 @@
 #include "BaseChecker.h"
 
-std::unordered_map<std::string, std::string> BaseChecker::bases;
+void BaseChecker::setBase(Name me, Name base) { bases[me] = base; }
 
-void BaseChecker::setBase(const std::string &me, const std::string &base) {
-    auto iter = bases.find(me);
-    if (iter != bases.end()) {
-        iter->second = base;
-    } else {
-        std::pair<std::string, std::string> p = {me, base};
-        bases.insert(p);
-    }
-}
-
-std::string BaseChecker::getBase(const std::string &me)
-{
+Name BaseChecker::getBase(Name me) const {
     auto it = bases.find(me);
     if (it != bases.end()) {
         return it->second;
     } else {
-        return "";
+        return Name();
     }
 }
 
-bool BaseChecker::isBase(const std::string &me, const std::string &base) {
-    auto it = bases.find(me);
+std::vector<Name> BaseChecker::getBaseChain(Name me) const {
+    std::vector<Name> v;
+    
+    for (Name cur = me; !cur.empty(); cur = getBase(cur)) {
+        v.push_back(cur);
+    }
+    return v;
+}
 
-    while (it != bases.end())
-    {
-        std::string basename = it->second;
-        if (basename == base) {
-            return true;
-        } else {
-            it = bases.find(basename);
+void BaseChecker::buildTable(const std::vector<Name> &classes) {
+    DerivedMap derived;
+    for (Name c : classes) {
+        Name base = getBase(c);
+        if (!base.empty()) {
+            derived[base].push_back(c);
+        }
+    }
+
+    unsigned counter = 0;
+    for (Name c : classes) {
+        if (getBase(c).empty()) {
+            number(c, derived, counter);
         }
     }
-    return false;
 }
-std::vector<std::string> BaseChecker::getBaseChain(const std::string &me) {
-    std::vector<std::string> v;
-    
-    for (std::string cur = me; !cur.empty(); cur = getBase(cur)) {
-        v.push_back(cur);
+
+// Walks the tree under root with an explicit stack, so that deep
+// hierarchies can't overflow the call stack
+void BaseChecker::number(Name root, const DerivedMap &derived,
+                         unsigned &counter) {
+    static const std::vector<Name> none;
+    // a class and the next of its derived classes to number
+    struct Frame {
+        Name me;
+        std::vector<Name>::const_iterator next, end;
+    };
+    std::vector<Frame> stack;
+
+    auto enter = [&](Name me) {
+        ranges[me].pre = ++counter;
+        auto it = derived.find(me);
+        const std::vector<Name> &ds = it != derived.end() ? it->second : none;
+        stack.push_back({me, ds.begin(), ds.end()});
+    };
+
+    enter(root);
+    while (!stack.empty()) {
+        Frame &top = stack.back();
+        if (top.next != top.end) {
+            enter(*top.next++);
+        } else {
+            ranges[top.me].last = counter;
+            stack.pop_back();
+        }
     }
-    return v;
+}
+
+const ClassRange &BaseChecker::getRange(Name me) const {
+    static const ClassRange none;
+    auto it = ranges.find(me);
+    return it != ranges.end() ? it->second : none;
+}
+
+bool BaseChecker::isBase(Name me, Name base) const {
+    return isBase(getRange(me), getRange(base));
 }
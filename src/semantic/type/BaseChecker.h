@@ -1,18 +1,40 @@
 #ifndef _SUB_CHECKER_H_
 #define _SUB_CHECKER_H_
 
+#include "ast/Name.h"
 #include <unordered_map>
 #include <vector>
 
+// Position of a class in a depth-first walk of the hierarchy. The classes
+// derived from it are exactly those numbered in (pre, last]
+struct ClassRange {
+    unsigned pre = 0;
+    unsigned last = 0;
+};
+
+// Class hierarchy of one program, owned by its CompileContext
 class BaseChecker {
 public:
-    BaseChecker() = delete;
-    static void setBase(const std::string &me, const std::string &base);
-    static std::string getBase(const std::string &me);
-    static bool isBase(const std::string &me, const std::string &base);
-    static std::vector<std::string> getBaseChain(const std::string &me);
+    void setBase(Name me, Name base);
+    Name getBase(Name me) const;
+    std::vector<Name> getBaseChain(Name me) const;
+
+    // Numbers the classes once all bases are set, which makes every isBase
+    // a range check instead of a walk up the chain
+    void buildTable(const std::vector<Name> &classes);
+    // An empty range for names that are not classes
+    const ClassRange &getRange(Name me) const;
+    bool isBase(Name me, Name base) const;
+    static bool isBase(const ClassRange &me, const ClassRange &base) {
+        return base.pre < me.pre && me.pre <= base.last;
+    }
 
 private:
-    static std::unordered_map<std::string, std::string> bases;
+    using DerivedMap = std::unordered_map<Name, std::vector<Name>, Name::Hash>;
+
+    std::unordered_map<Name, Name, Name::Hash> bases;
+    std::unordered_map<Name, ClassRange, Name::Hash> ranges;
+
+    void number(Name root, const DerivedMap &derived, unsigned &counter);
 };
-#endif
\ No newline at end of file
+#endif
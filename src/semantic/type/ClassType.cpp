@@ -1,27 +1,37 @@
 #include "Type.h"
 #include "BaseChecker.h"
 
-ClassType::ClassType(const std::string &name) : Type(CLASS_TYPE), name(name) {}
+ClassType::ClassType(Name name, const BaseChecker *bc)
+    : Type(CLASS_TYPE), name(name), baseChecker(bc) {}
 
 Type::Relation ClassType::compare(const std::shared_ptr<Type> other) const {
     if (other->getKind() == ERROR_TYPE) {
         return SUBTYPE;
     }
     
-    if (other->getKind() == CLASS_TYPE) {
-        std::string otherName = std::dynamic_pointer_cast<ClassType>(other)->getName();
+    if (other->getKind() != CLASS_TYPE) {
+        return DIFFTPYE;
+    }
+    if (other.get() == this) {
+        return SAMETPYE;
+    }
 
-        if (otherName == name) {
-            return SAMETPYE;
-        } else if (BaseChecker::isBase(name, otherName)) {
-            return SUBTYPE;
-        }
+    const ClassType *o = static_cast<const ClassType *>(other.get());
+    if (BaseChecker::isBase(getRange(), o->getRange())) {
+        return SUBTYPE;
     }
     return DIFFTPYE;
 }
 
 std::string ClassType::toString() const {
-    return std::string("class ").append(name);
+    return std::string("class ").append(name.str());
 }
 
-std::string ClassType::getName() const { return name; }
\ No newline at end of file
+Name ClassType::getName() const { return name; }
+
+const ClassRange &ClassType::getRange() const {
+    if (!range) {
+        range = &baseChecker->getRange(name);
+    }
+    return *range;
+}
\ No newline at end of file
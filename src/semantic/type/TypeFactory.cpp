@@ -0,0 +1,46 @@
+#include "TypeFactory.h"
+
+TypeFactory::TypeFactory(const BaseChecker *bc)
+    : baseChecker(bc), error(std::make_shared<ErrorType>()) {
+    for (Type::TypeKind kind : {Type::INTEGER_TYPE, Type::BOOL_TYPE,
+                                Type::STRING_TYPE, Type::NULL_TYPE,
+                                Type::VOID_TYPE}) {
+        builtIns[kind] = std::make_shared<BuiltInType>(kind);
+    }
+}
+
+std::shared_ptr<Type> TypeFactory::getBuiltIn(Type::TypeKind kind) const {
+    return builtIns[kind];
+}
+
+std::shared_ptr<ClassType> TypeFactory::getClass(Name name) {
+    std::shared_ptr<ClassType> &t = classes[name];
+    if (!t) {
+        t = std::make_shared<ClassType>(name, baseChecker);
+    }
+    return t;
+}
+
+std::shared_ptr<ArrayType>
+TypeFactory::getArray(const std::shared_ptr<Type> &base) {
+    std::shared_ptr<ArrayType> &t = arrays[base.get()];
+    if (!t) {
+        t = std::make_shared<ArrayType>(base);
+    }
+    return t;
+}
+
+std::shared_ptr<MethodType>
+TypeFactory::getMethod(const std::shared_ptr<Type> &retType,
+                       const std::vector<std::shared_ptr<Type>> &argsType) {
+    std::vector<const Type *> key = {retType.get()};
+    for (const auto &a : argsType) {
+        key.push_back(a.get());
+    }
+
+    std::shared_ptr<MethodType> &t = methods[key];
+    if (!t) {
+        t = std::make_shared<MethodType>(retType, argsType);
+    }
+    return t;
+}
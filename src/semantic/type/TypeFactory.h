@@ -0,0 +1,43 @@
+#ifndef _TYPE_FACTORY_H_
+#define _TYPE_FACTORY_H_
+
+#include "ArrayType.h"
+#include "Type.h"
+#include "ast/Name.h"
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+class BaseChecker;
+
+// Types of one program, owned by its CompileContext. Every type is created
+// once and handed out again on later requests, so two types are the same
+// exactly when they are the same object
+class TypeFactory {
+public:
+    TypeFactory(const BaseChecker *bc);
+    TypeFactory(const TypeFactory &) = delete;
+    TypeFactory &operator=(const TypeFactory &) = delete;
+
+    // int, bool, string, null or void
+    std::shared_ptr<Type> getBuiltIn(Type::TypeKind kind) const;
+    std::shared_ptr<Type> getError() const { return error; }
+    std::shared_ptr<ClassType> getClass(Name name);
+    std::shared_ptr<ArrayType> getArray(const std::shared_ptr<Type> &base);
+    std::shared_ptr<MethodType>
+    getMethod(const std::shared_ptr<Type> &retType,
+              const std::vector<std::shared_ptr<Type>> &argsType);
+
+private:
+    const BaseChecker *baseChecker;
+
+    std::shared_ptr<Type> builtIns[Type::ERROR_TYPE];
+    std::shared_ptr<Type> error;
+    std::unordered_map<Name, std::shared_ptr<ClassType>, Name::Hash> classes;
+    std::unordered_map<const Type *, std::shared_ptr<ArrayType>> arrays;
+    // keyed by the return type followed by the argument types
+    std::map<std::vector<const Type *>, std::shared_ptr<MethodType>> methods;
+};
+
+#endif
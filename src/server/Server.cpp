@@ -0,0 +1,148 @@
+#include "Server.h"
+#include "protocol.h"
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <getopt.h>
+#include <iostream>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+static bool readAll(int fd, char *buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = read(fd, buf, len);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        buf += n;
+        len -= n;
+    }
+    return true;
+}
+
+// Receive the payload length together with the client's stdio fds
+static bool recvHeader(int conn, uint32_t &len, int fds[DECAF_PROTO_NFDS]) {
+    char control[CMSG_SPACE(sizeof(int) * DECAF_PROTO_NFDS)];
+    struct iovec iov = {&len, sizeof(len)};
+    struct msghdr msg = {};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    if (recvmsg(conn, &msg, MSG_WAITALL) != sizeof(len)) {
+        return false;
+    }
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    if (cmsg == nullptr || cmsg->cmsg_level != SOL_SOCKET ||
+        cmsg->cmsg_type != SCM_RIGHTS ||
+        cmsg->cmsg_len != CMSG_LEN(sizeof(int) * DECAF_PROTO_NFDS)) {
+        return false;
+    }
+    memcpy(fds, CMSG_DATA(cmsg), sizeof(int) * DECAF_PROTO_NFDS);
+    return len <= DECAF_PROTO_MAX_PAYLOAD;
+}
+
+// Runs in a process of its own: compile in a forked worker that takes over
+// the client's stdio and cwd, then report how the worker exited
+static int handleRequest(int conn, int (*driver)(int, char **)) {
+    uint32_t len;
+    int fds[DECAF_PROTO_NFDS];
+
+    if (!recvHeader(conn, len, fds)) {
+        std::cerr << "[error] bad request" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::vector<char> payload(len);
+    if (!readAll(conn, payload.data(), len) || len == 0 ||
+        payload.back() != '\0') {
+        std::cerr << "[error] bad request" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // "<cwd>\0<arg1>\0..."
+    std::vector<char *> args;
+    for (size_t i = 0; i < len; i += strlen(&payload[i]) + 1) {
+        args.push_back(&payload[i]);
+    }
+    const char *cwd = args[0];
+    args[0] = const_cast<char *>("decaf");
+    args.push_back(nullptr);
+
+    pid_t worker = fork();
+    if (worker == 0) {
+        close(conn);
+        for (int i = 0; i < DECAF_PROTO_NFDS; i++) {
+            dup2(fds[i], i);
+            close(fds[i]);
+        }
+        if (chdir(cwd) != 0) {
+            std::cerr << "[error] fail to enter " << cwd << " "
+                      << strerror(errno) << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        // a fresh getopt scan over the client's command line
+        optind = 0;
+        exit(driver(args.size() - 1, args.data()));
+    }
+    for (int i = 0; i < DECAF_PROTO_NFDS; i++) {
+        close(fds[i]);
+    }
+
+    int32_t ret = EXIT_FAILURE;
+    int status;
+    if (worker > 0 && waitpid(worker, &status, 0) == worker) {
+        ret = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+    }
+    ssize_t n = write(conn, &ret, sizeof(ret));
+    (void)n;
+    return EXIT_SUCCESS;
+}
+
+int runServer(const std::string &sockPath, int (*driver)(int, char **)) {
+    struct sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    if (sockPath.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "[error] socket path too long " << sockPath << std::endl;
+        return EXIT_FAILURE;
+    }
+    strcpy(addr.sun_path, sockPath.c_str());
+
+    int lfd = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(sockPath.c_str());
+    if (lfd < 0 || bind(lfd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        listen(lfd, SOMAXCONN) != 0) {
+        std::cerr << "[error] fail to listen on " << sockPath << " "
+                  << strerror(errno) << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // request handlers are never waited for
+    signal(SIGCHLD, SIG_IGN);
+    for (;;) {
+        int conn = accept(lfd, nullptr, nullptr);
+        if (conn < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "[error] accept " << strerror(errno) << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        pid_t handler = fork();
+        if (handler == 0) {
+            close(lfd);
+            // the worker and the linker it spawns are waited for
+            signal(SIGCHLD, SIG_DFL);
+            _exit(handleRequest(conn, driver));
+        }
+        close(conn);
+    }
+}
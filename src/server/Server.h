@@ -0,0 +1,11 @@
+#ifndef _DECAF_SERVER_H_
+#define _DECAF_SERVER_H_
+#include <string>
+
+// Resident compiler listening on a Unix socket. Each request carries the
+// client's stdin/stdout/stderr (SCM_RIGHTS), its working directory and its
+// command line, which is run by driver in a process forked from the warm
+// server. The exit status of driver is sent back to the client
+int runServer(const std::string &sockPath, int (*driver)(int, char **));
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef _DECAF_PROTOCOL_H_
+#define _DECAF_PROTOCOL_H_
+
+#include <stdint.h>
+
+/*
+ * Shared by the server and the C client.
+ *
+ * request:  uint32_t payload length, sent with SCM_RIGHTS carrying the
+ *           client's fds 0, 1 and 2, followed by the payload:
+ *           "<cwd>\0<arg1>\0<arg2>\0..."
+ * response: int32_t exit status of the compilation
+ */
+#define DECAF_PROTO_NFDS 3
+#define DECAF_PROTO_MAX_PAYLOAD (1 << 20)
+
+#endif
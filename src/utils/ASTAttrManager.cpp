@@ -1,37 +1,53 @@
 #include "ASTAttrManager.h"
 
-void ASTAttrManager::setHasRet(antlr4::tree::ParseTree *tree, bool b) {
-    hasRet[tree] = b;
+void ASTAttrManager::resizeNodeTables(unsigned numNodes) {
+    hasRet.resize(numNodes);
+    isClassName.resize(numNodes);
+    exprTypes.resize(numNodes);
+    scopes.resize(numNodes);
 }
 
-bool ASTAttrManager::getHasRet(antlr4::tree::ParseTree *tree) {
-    return hasRet[tree];
+void ASTAttrManager::setHasRet(const ASTNode *node, bool b) {
+    grow(hasRet, node->id) = b;
 }
 
-void ASTAttrManager::setIsClassName(antlr4::tree::ParseTree *tree, bool b) {
-    isClassName[tree] = b;
+bool ASTAttrManager::getHasRet(const ASTNode *node) const {
+    return lookup(hasRet, node->id);
 }
 
-bool ASTAttrManager::getIsClassName(antlr4::tree::ParseTree *tree) {
-    return isClassName[tree];
+void ASTAttrManager::setIsClassName(const ASTNode *node, bool b) {
+    grow(isClassName, node->id) = b;
 }
 
-void ASTAttrManager::setExprType(DecafParserParser::ExprContext *ctx,
+bool ASTAttrManager::getIsClassName(const ASTNode *node) const {
+    return lookup(isClassName, node->id);
+}
+
+void ASTAttrManager::setExprType(const Expr *expr,
                                  const std::shared_ptr<Type> &t) {
-    exprTypes[ctx] = t;
+    grow(exprTypes, expr->id) = t;
 }
 
 std::shared_ptr<Type>
-ASTAttrManager::getExprType(DecafParserParser::ExprContext *ctx) {
-    return exprTypes[ctx];
+ASTAttrManager::getExprType(const Expr *expr) const {
+    return lookup(exprTypes, expr->id);
 }
 
 void ASTAttrManager::setSymbolLLVMValue(const std::shared_ptr<Symbol> &sym,
                                         llvm::Value *v) {
-    symLLVMVals[sym] = v;
+    grow(symLLVMVals, sym->id) = v;
 }
 
 llvm::Value*
-ASTAttrManager::getSymbolLLVMVal(const std::shared_ptr<Symbol> &sym) {
-    return symLLVMVals[sym];
+ASTAttrManager::getSymbolLLVMVal(const std::shared_ptr<Symbol> &sym) const {
+    return lookup(symLLVMVals, sym->id);
+}
+
+void ASTAttrManager::setScope(const ASTNode *node,
+                              const std::shared_ptr<Scope> &scope) {
+    grow(scopes, node->id) = scope;
+}
+
+std::shared_ptr<Scope> ASTAttrManager::getScope(const ASTNode *node) const {
+    return lookup(scopes, node->id);
 }
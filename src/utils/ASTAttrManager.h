@@ -1,36 +1,61 @@
 #ifndef _AST_ATTR_MANAGER_H_
 #define _AST_ATTR_MANAGER_H_
-#include "DecafParserParser.h"
-#include "antlr4-runtime.h"
+#include "ast/AST.h"
+#include "semantic/Scope.h"
 #include "semantic/Symbol.h"
 #include "semantic/Type.h"
 #include "llvm/IR/Value.h"
 #include <memory>
-#include <unordered_map>
+#include <vector>
 
-// This acts like a collection of antlr4::ParseTreeProperty. It stores
-// various attributes of AST nodes
+// Various attributes of AST nodes, filled in by the semantic checks and
+// used by code generation. They are kept in vectors indexed by node or
+// symbol id. The node tables are sized for the whole AST up front, the
+// symbol table grows on demand; reading an attribute that was never set
+// gives its default and leaves the tables alone
 class ASTAttrManager {
 public:
-    void setHasRet(antlr4::tree::ParseTree *tree, bool b);
-    bool getHasRet(antlr4::tree::ParseTree *tree);
+    // Make room for the attributes of nodes with ids below numNodes
+    void resizeNodeTables(unsigned numNodes);
 
-    void setIsClassName(antlr4::tree::ParseTree *tree, bool b);
-    bool getIsClassName(antlr4::tree::ParseTree *tree);
+    void setHasRet(const ASTNode *node, bool b);
+    bool getHasRet(const ASTNode *node) const;
 
-    void setExprType(DecafParserParser::ExprContext *ctx,
-                     const std::shared_ptr<Type> &t);
-    std::shared_ptr<Type> getExprType(DecafParserParser::ExprContext *ctx);
+    void setIsClassName(const ASTNode *node, bool b);
+    bool getIsClassName(const ASTNode *node) const;
+
+    void setExprType(const Expr *expr, const std::shared_ptr<Type> &t);
+    std::shared_ptr<Type> getExprType(const Expr *expr) const;
 
     void setSymbolLLVMValue(const std::shared_ptr<Symbol> &sym, llvm::Value *v);
-    llvm::Value* getSymbolLLVMVal(const std::shared_ptr<Symbol> &sym);
+    llvm::Value* getSymbolLLVMVal(const std::shared_ptr<Symbol> &sym) const;
+
+    // Scope opened by a class, method, block or for statement
+    void setScope(const ASTNode *node, const std::shared_ptr<Scope> &scope);
+    std::shared_ptr<Scope> getScope(const ASTNode *node) const;
 
 private:
-    std::unordered_map<antlr4::tree::ParseTree *, bool> hasRet;
-    std::unordered_map<antlr4::tree::ParseTree *, bool> isClassName;
-    std::unordered_map<DecafParserParser::ExprContext *, std::shared_ptr<Type>>
-        exprTypes;
-    std::unordered_map<std::shared_ptr<Symbol>, llvm::Value *> symLLVMVals;
+    // indexed by node id
+    std::vector<bool> hasRet;
+    std::vector<bool> isClassName;
+    std::vector<std::shared_ptr<Type>> exprTypes;
+    std::vector<std::shared_ptr<Scope>> scopes;
+    // indexed by symbol id
+    std::vector<llvm::Value *> symLLVMVals;
+
+    template <typename T>
+    static typename std::vector<T>::reference grow(std::vector<T> &v,
+                                                   unsigned id) {
+        if (id >= v.size()) {
+            v.resize(id + 1);
+        }
+        return v[id];
+    }
+
+    template <typename T>
+    static T lookup(const std::vector<T> &v, unsigned id) {
+        return id < v.size() ? v[id] : T();
+    }
 };
 
-#endif
\ No newline at end of file
+#endif
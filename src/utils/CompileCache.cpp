@@ -0,0 +1,102 @@
+#include "CompileCache.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA1.h"
+#include <fstream>
+
+// Bump when the generated code changes in a way the binary identity below
+// wouldn't notice
+#define CACHE_VERSION "1"
+
+CompileCache::CompileCache(const std::string &dir) : dir(dir) {
+    llvm::sys::fs::create_directories(dir);
+}
+
+// The decaf binary's path, size and mtime, so a rebuilt compiler never sees
+// entries of the old one
+std::string CompileCache::getCompilerId() {
+    static const std::string id = [] {
+        std::string exe = llvm::sys::fs::getMainExecutable(
+            nullptr, (void *)(intptr_t)&CompileCache::getCompilerId);
+        llvm::sys::fs::file_status st;
+        std::string s = std::string(CACHE_VERSION).append(":").append(exe);
+        if (!llvm::sys::fs::status(exe, st)) {
+            s.append(":")
+                .append(std::to_string(st.getSize()))
+                .append(":")
+                .append(std::to_string(
+                    st.getLastModificationTime().time_since_epoch().count()));
+        }
+        return s;
+    }();
+    return id;
+}
+
+std::string CompileCache::getKey(const std::string &config,
+                                 llvm::StringRef source) {
+    llvm::SHA1 hasher;
+    hasher.update(getCompilerId());
+    hasher.update("\n");
+    hasher.update(config);
+    hasher.update("\n");
+    hasher.update(source);
+    return llvm::toHex(hasher.final(), true);
+}
+
+std::string CompileCache::getEntryPath(const std::string &key) {
+    llvm::SmallString<128> path(dir);
+    llvm::sys::path::append(path, key);
+    return path.str().str();
+}
+
+std::string CompileCache::getTempPath(const std::string &key) {
+    llvm::SmallString<128> path;
+    if (llvm::sys::fs::createUniqueFile(
+            getEntryPath(key) + "-%%%%%%%%.tmp", path)) {
+        return "";
+    }
+    return path.str().str();
+}
+
+bool CompileCache::fetch(const std::string &key, const std::string &path,
+                         std::ostream &os) {
+    std::string entry = getEntryPath(key);
+
+    if (path.empty()) {
+        std::ifstream ifs(entry, std::ios::binary);
+        if (!ifs.is_open()) {
+            return false;
+        }
+        os << ifs.rdbuf();
+        return true;
+    }
+
+    llvm::sys::fs::file_status st;
+    if (llvm::sys::fs::status(entry, st) ||
+        llvm::sys::fs::copy_file(entry, path)) {
+        return false;
+    }
+    // executables stay executable
+    llvm::sys::fs::setPermissions(path, st.permissions());
+    return true;
+}
+
+bool CompileCache::store(const std::string &key, const std::string &path) {
+    std::string tmp = getTempPath(key);
+    if (tmp.empty()) {
+        return false;
+    }
+
+    // Readers only ever see complete entries, since rename is atomic
+    llvm::sys::fs::file_status st;
+    if (llvm::sys::fs::status(path, st) ||
+        llvm::sys::fs::copy_file(path, tmp) ||
+        llvm::sys::fs::setPermissions(tmp, st.permissions()) ||
+        llvm::sys::fs::rename(tmp, getEntryPath(key))) {
+        llvm::sys::fs::remove(tmp);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,34 @@
+#ifndef _COMPILE_CACHE_H_
+#define _COMPILE_CACHE_H_
+#include <ostream>
+#include <string>
+
+#include "llvm/ADT/StringRef.h"
+
+// On-disk cache of compilation outputs (IR, bitcode, objects, executables),
+// one file per entry named after the SHA1 of everything that determines it
+class CompileCache {
+public:
+    CompileCache(const std::string &dir);
+
+    // Hash of the compiler itself, the configuration (task, options, target)
+    // and the source text
+    static std::string getKey(const std::string &config,
+                              llvm::StringRef source);
+
+    // On a hit, copy the entry to path, or to os if path is empty
+    bool fetch(const std::string &key, const std::string &path,
+               std::ostream &os);
+    // Add the file at path under key, atomically
+    bool store(const std::string &key, const std::string &path);
+    // A path inside the cache directory to produce an entry into
+    std::string getTempPath(const std::string &key);
+
+private:
+    std::string dir;
+
+    std::string getEntryPath(const std::string &key);
+    static std::string getCompilerId();
+};
+
+#endif
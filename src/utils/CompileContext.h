@@ -0,0 +1,22 @@
+#ifndef _COMPILE_CONTEXT_H_
+#define _COMPILE_CONTEXT_H_
+#include "ast/AST.h"
+#include "semantic/Scope.h"
+#include "semantic/type/BaseChecker.h"
+#include "semantic/type/TypeFactory.h"
+#include "utils/ASTAttrManager.h"
+#include <memory>
+
+// Everything owned by the compilation of one program. Nothing is shared
+// between contexts, so programs may be compiled one after another or on
+// several threads at once
+struct CompileContext {
+    BaseChecker baseChecker;
+    TypeFactory types{&baseChecker};
+    ASTContext ast;
+    std::shared_ptr<Scope> globalScope;
+    std::shared_ptr<ASTAttrManager> attrManager =
+        std::make_shared<ASTAttrManager>();
+};
+
+#endif
@@ -0,0 +1,19 @@
+#include "LiteralTable.h"
+
+void LiteralTable::setIntValue(const antlr4::Token *tok, int value) {
+    intVals[tok] = value;
+}
+
+int LiteralTable::getIntValue(const antlr4::Token *tok) const {
+    return intVals.at(tok);
+}
+
+void LiteralTable::setStringValue(const antlr4::Token *tok,
+                                  std::string value) {
+    stringVals[tok] = std::move(value);
+}
+
+const std::string &
+LiteralTable::getStringValue(const antlr4::Token *tok) const {
+    return stringVals.at(tok);
+}
@@ -0,0 +1,22 @@
+#ifndef _LITERAL_TABLE_H_
+#define _LITERAL_TABLE_H_
+#include "antlr4-runtime.h"
+#include <string>
+#include <unordered_map>
+
+// Values of the int and string literals of a program, decoded once by the
+// lexer. Later phases look them up by token instead of parsing the text
+class LiteralTable {
+public:
+    void setIntValue(const antlr4::Token *tok, int value);
+    int getIntValue(const antlr4::Token *tok) const;
+
+    void setStringValue(const antlr4::Token *tok, std::string value);
+    const std::string &getStringValue(const antlr4::Token *tok) const;
+
+private:
+    std::unordered_map<const antlr4::Token *, int> intVals;
+    std::unordered_map<const antlr4::Token *, std::string> stringVals;
+};
+
+#endif
@@ -1,4 +1,5 @@
 #include "Pos.h"
+#include "antlr4-runtime.h"
 
 Pos::Pos(){};
 
@@ -25,39 +26,3 @@ std::string Pos::toString() const {
 Pos getTokenPos(const antlr4::Token *tok) {
     return Pos(tok->getLine(), tok->getCharPositionInLine());
 }
-
-Pos getClassPos(DecafParserParser::ClassDefContext *ctx) {
-    return getTokenPos(ctx->CLASS()->getSymbol());
-}
-
-Pos getMethodPos(DecafParserParser::MethodDefContext *ctx) {
-    return getTokenPos(ctx->id()->IDENTIFIER()->getSymbol());
-}
-
-Pos getVarPos(DecafParserParser::VarContext *ctx) {
-    return getTokenPos(ctx->id()->IDENTIFIER()->getSymbol());
-}
-
-Pos getBlockPos(DecafParserParser::BlockContext *ctx) {
-    return getTokenPos(ctx->LBRACE()->getSymbol());
-}
-
-Pos getForPos(DecafParserParser::ForStmtContext *ctx) {
-    return getTokenPos(ctx->FOR()->getSymbol());
-}
-
-Pos getIdPos(DecafParserParser::IdContext *ctx) {
-    return getTokenPos(ctx->IDENTIFIER()->getSymbol());
-}
-
-Pos getBreakPos(DecafParserParser::BreakStmtContext *ctx) {
-    return getTokenPos(ctx->BREAK()->getSymbol());
-}
-
-Pos getThisPos(DecafParserParser::ThisExprContext *ctx) {
-    return getTokenPos(ctx->THIS()->getSymbol());
-}
-
-Pos getInstanceofPos(DecafParserParser::InstanceofExprContext *ctx) {
-    return getTokenPos(ctx->INSTANCEOF()->getSymbol());
-}
\ No newline at end of file
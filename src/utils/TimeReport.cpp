@@ -0,0 +1,80 @@
+#include "TimeReport.h"
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <iomanip>
+#include <sys/resource.h>
+#include <unistd.h>
+
+// Resident set size in KB
+static long getRSS() {
+    long pages = 0;
+    FILE *f = fopen("/proc/self/statm", "r");
+
+    if (f) {
+        if (fscanf(f, "%*ld %ld", &pages) != 1) {
+            pages = 0;
+        }
+        fclose(f);
+    }
+    return pages * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+static long getPeakRSS() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+TimeReport::Sample TimeReport::sample() {
+    Sample s;
+    struct timespec cpu;
+
+    // CPU time of this thread only, batch mode compiles on several
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu);
+    s.cpu = cpu.tv_sec * 1e3 + cpu.tv_nsec / 1e6;
+    s.wall = std::chrono::duration<double, std::milli>(
+                 std::chrono::steady_clock::now().time_since_epoch())
+                 .count();
+    s.rss = getRSS();
+    return s;
+}
+
+TimeReport::Phase::Phase(TimeReport *report, const std::string &name)
+    : report(report), name(name) {
+    if (report) {
+        begin = sample();
+    }
+}
+
+TimeReport::Phase::~Phase() {
+    if (report) {
+        Sample end = sample();
+        report->records.push_back({name, end.wall - begin.wall,
+                                   end.cpu - begin.cpu, end.rss - begin.rss});
+    }
+}
+
+void TimeReport::print(std::ostream &os) const {
+    double wall = 0, cpu = 0;
+    long rss = 0;
+
+    os << "===---------------------------------------------------------===\n"
+       << "                  Decaf compilation time report\n"
+       << "===---------------------------------------------------------===\n"
+       << "   Wall (ms)    CPU (ms)  Process RSS delta (KB)  Phase\n";
+    os << std::fixed << std::setprecision(3);
+    for (auto &r : records) {
+        os << std::setw(12) << r.wall << std::setw(12) << r.cpu
+           << std::setw(24) << std::showpos << r.rssDelta << std::noshowpos
+           << "  " << r.name << "\n";
+        wall += r.wall;
+        cpu += r.cpu;
+        rss += r.rssDelta;
+    }
+    os << std::setw(12) << wall << std::setw(12) << cpu << std::setw(24)
+       << std::showpos << rss << std::noshowpos << "  Total\n";
+    os << "Peak process RSS: " << getPeakRSS() << " KB\n";
+    os.unsetf(std::ios::floatfield);
+    os << std::flush;
+}
@@ -0,0 +1,45 @@
+#ifndef _TIME_REPORT_H_
+#define _TIME_REPORT_H_
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Wall time, CPU time and RSS growth of each compiler phase, printed by
+// -ftime-report. The RSS is the whole process's, only meaningful while
+// nothing else compiles
+class TimeReport {
+public:
+    struct Sample {
+        double wall;
+        double cpu;
+        long rss;
+    };
+
+    // Measures from construction to destruction, does nothing if report is
+    // null so callers don't have to check
+    class Phase {
+    public:
+        Phase(TimeReport *report, const std::string &name);
+        ~Phase();
+
+    private:
+        TimeReport *report;
+        std::string name;
+        Sample begin;
+    };
+
+    void print(std::ostream &os) const;
+
+private:
+    struct Record {
+        std::string name;
+        double wall;
+        double cpu;
+        long rssDelta;
+    };
+    std::vector<Record> records;
+
+    static Sample sample();
+};
+
+#endif
@@ -56,6 +56,4 @@ class UnrecognizedChar : public BaseDecafParseException {};
 
 class IntTooLarge : public BaseDecafParseException {};
 
-bool isIntegerTooLarge(const std::string &input);
-
 #endif
\ No newline at end of file
@@ -1,8 +1,15 @@
 #include "printer.h"
 #include "antlr4-runtime.h"
 #include "error.h"
+#include <iostream>
 #include <string>
 
+static thread_local std::ostream *diagStream = &std::cerr;
+
+void setDiagnosticStream(std::ostream *os) { diagStream = os; }
+
+std::ostream &getDiagnosticStream() { return *diagStream; }
+
 static std::string getErrorText(CompileErrors err,
                                 const std::vector<std::string> &texts) {
     std::string errText;
@@ -146,7 +153,7 @@ std::string reportErrorText(CompileErrors err,
     errText.append(getErrorText(err, texts));
     errText += "\n";
     
-    std::cerr << errText;
+    *diagStream << errText;
     return errText;
 }
 
@@ -163,6 +170,6 @@ std::string reportErrorText(const Pos &pos, CompileErrors err,
     errText.append(getErrorText(err, texts));
 
     errText += "\n";
-    std::cerr << errText;
+    *diagStream << errText;
     return errText;
 }
\ No newline at end of file
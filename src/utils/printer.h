@@ -3,8 +3,14 @@
 #include "antlr4-runtime.h"
 #include "error.h"
 #include "Pos.h"
+#include <ostream>
 #include <string>
 
+// Compile errors of the current thread go to this stream, std::cerr by
+// default. Each thread compiling a program may redirect its own
+void setDiagnosticStream(std::ostream *os);
+std::ostream &getDiagnosticStream();
+
 std::string reportErrorText(CompileErrors err,
                             const std::vector<std::string> &texts);
 std::string reportErrorText(const Pos &pos, CompileErrors err,